@@ -62,6 +62,9 @@ int main()
      * the memory for the arrays is automatically deallocated.
      *
      * No need to call delete or delete[] manually!
+     *
+     * For multi-GB arrays (huge pages, NUMA placement) see 34numa_huge_pages.cpp,
+     * which uses unique_ptr<T[]> with a custom munmap deleter.
      */
 
     return 0;
@@ -156,6 +156,12 @@ ADDITIONAL:
   This is because the first call returns `void`, making the second call
   effectively: `p1 += void`, which is invalid.
 
+ARRAYS OF POINTS:
+- Chaining operator+ over whole arrays creates one temporary per operator.
+  See 38expression_templates.cpp for fusing `a + b * 2 - c` into one loop.
+- Rotating / scaling / translating many points: one 3x3 matrix, applied
+  4 points at a time. See 58simd_point_transforms.cpp.
+
 REFERENCE:
 - https://en.cppreference.com/w/cpp/language/operators.html
 */
@@ -39,6 +39,8 @@ struct Point
 };
 
 // Another example: using 'this' in a struct with strings
+// (for a heap-free, memcpy-able version of Person see 35fixed_string.cpp,
+//  and for names stored as 32-bit interned ids see 36string_interning.cpp)
 struct Person
 {
     std::string name;
@@ -0,0 +1,243 @@
+#include <iostream>    // For std::cout
+#include <string>      // For std::string (the heap-allocating version)
+#include <string_view> // For std::string_view (non-owning view of characters)
+#include <cstring>     // For std::memcpy
+#include <vector>      // For a flat array of records
+#include <type_traits> // For std::is_trivially_copyable_v
+#include <utility>     // For std::move
+#include <algorithm>   // For std::min, std::copy_n
+#include <cstdio>      // For std::tmpfile
+
+#include <sys/mman.h> // mmap, munmap
+#include <unistd.h>   // write, fileno
+
+/*
+----------------------------------------------------------------------
+TOPIC: FIXED-CAPACITY INLINE STRINGS
+----------------------------------------------------------------------
+In 32struct_this_keyword.cpp, Person stores `std::string name`.
+
+std::string is great, but:
+- Only short strings (≤ 15 chars with libstdc++) fit in the object itself
+  ("Small String Optimization", SSO). Longer names go to the heap.
+- It holds a pointer, so a Person is NOT trivially copyable:
+  you cannot memcpy an array of them, write it to a file, or mmap it back.
+
+If we know names are short (say ≤ 31 chars), we can store the characters
+INSIDE the object in a fixed-size array:
+
+    FixedString<32> → char data[31] + 1 byte length = 32 bytes, no pointer
+
+Then a struct made only of such fields is trivially copyable, and an
+array of them is just one flat block of bytes.
+----------------------------------------------------------------------
+*/
+
+// ------------------------ FixedString<N> -----------------------------
+
+/*
+N is the TOTAL size in bytes. One byte holds the length, so the capacity
+is N - 1 characters. Longer input is truncated (a real codebase might
+throw or assert instead — we keep it simple and predictable).
+*/
+template <std::size_t N>
+struct FixedString
+{
+    static_assert(N >= 2 && N <= 256, "length must fit in one byte");
+
+    char chars[N - 1]{}; // zero-filled, so two equal strings compare equal bytewise
+    unsigned char len = 0;
+
+    static constexpr std::size_t capacity() { return N - 1; }
+
+    constexpr FixedString() = default;
+
+    // constexpr: can build FixedString values at compile time
+    constexpr FixedString(std::string_view sv)
+    {
+        assign(sv);
+    }
+
+    // Allows FixedString<16> s = "hello"; (string literal)
+    constexpr FixedString(const char *s) : FixedString(std::string_view(s)) {}
+
+    constexpr void assign(std::string_view sv)
+    {
+        std::size_t n = std::min(sv.size(), capacity());
+        for (std::size_t i = 0; i < capacity(); i++)
+        {
+            chars[i] = i < n ? sv[i] : '\0';
+        }
+        len = static_cast<unsigned char>(n);
+    }
+
+    constexpr std::size_t size() const { return len; }
+    constexpr bool empty() const { return len == 0; }
+
+    // string_view interop: cheap, no copy, works with any API taking string_view
+    constexpr std::string_view view() const { return std::string_view(chars, len); }
+    constexpr operator std::string_view() const { return view(); }
+
+    // Explicit conversion when you really need an owning std::string
+    std::string str() const { return std::string(view()); }
+
+    constexpr bool operator==(const FixedString &rhs) const { return view() == rhs.view(); }
+    constexpr bool operator==(std::string_view rhs) const { return view() == rhs; }
+};
+
+template <std::size_t N>
+std::ostream &operator<<(std::ostream &os, const FixedString<N> &s)
+{
+    return os << s.view();
+}
+
+// Compile-time checks: constexpr construction really works
+constexpr FixedString<16> kDefaultName = "Unknown";
+static_assert(kDefaultName.size() == 7);
+static_assert(kDefaultName == std::string_view("Unknown"));
+static_assert(sizeof(FixedString<32>) == 32);
+static_assert(std::is_trivially_copyable_v<FixedString<32>>);
+
+// ------------------------ Person with std::string -----------------------------
+
+/*
+Same Person as in 32struct_this_keyword.cpp, plus an rvalue overload.
+
+- setName(const std::string&) → always COPIES the characters
+- setName(std::string&&)      → MOVES: steals the heap buffer of a temporary
+                                 (see 33move.cpp for move semantics)
+*/
+struct Person
+{
+    std::string name;
+
+    const std::string &getName() const { return this->name; }
+
+    Person &setName(const std::string &newName)
+    {
+        this->name = newName; // copy
+        return *this;
+    }
+
+    Person &setName(std::string &&newName)
+    {
+        this->name = std::move(newName); // move, no character copy for long names
+        return *this;
+    }
+};
+
+// ------------------------ FlatPerson with FixedString -----------------------------
+
+/*
+Every member is stored inline → the whole struct is trivially copyable.
+setName takes a string_view so it accepts std::string, literals,
+other FixedStrings, ... without creating a temporary std::string.
+*/
+struct FlatPerson
+{
+    FixedString<32> name;
+    int age = 0;
+
+    std::string_view getName() const { return name.view(); }
+
+    FlatPerson &setName(std::string_view newName)
+    {
+        name.assign(newName);
+        return *this;
+    }
+
+    FlatPerson &setAge(int newAge)
+    {
+        age = newAge;
+        return *this;
+    }
+};
+
+static_assert(std::is_trivially_copyable_v<FlatPerson>,
+              "FlatPerson must stay memcpy-able");
+static_assert(!std::is_trivially_copyable_v<Person>,
+              "std::string is not trivially copyable");
+
+int main()
+{
+    // ---------------------- COPY vs MOVE into std::string ------------------------
+    Person person;
+    std::string long_name = "Bartholomew Montgomery-Fitzgerald"; // > 15 chars → heap
+    const char *before = long_name.data();
+
+    person.setName(long_name); // lvalue → copy overload
+    std::cout << "After copy, buffers shared? " << (person.getName().data() == before) << '\n';
+
+    person.setName(std::move(long_name)); // rvalue → move overload
+    std::cout << "After move, buffers shared? " << (person.getName().data() == before) << '\n';
+
+    // ---------------------- FixedString basics ------------------------
+    FlatPerson alice;
+    alice.setName("Alice").setAge(30); // chaining works just like in 32.cpp
+    std::cout << "\nName: " << alice.getName() << ", age " << alice.age
+              << ", sizeof(FlatPerson) = " << sizeof(FlatPerson) << '\n';
+
+    FixedString<8> truncated("a-very-long-name");
+    std::cout << "Truncated to capacity " << truncated.capacity() << ": " << truncated << '\n';
+
+    // ---------------------- FLAT ARRAY + memcpy ------------------------
+    std::vector<FlatPerson> people(4);
+    people[0].setName("Alice").setAge(30);
+    people[1].setName("Bob").setAge(25);
+    people[2].setName("Charlie").setAge(41);
+    people[3].setName("Dana").setAge(19);
+
+    // One memcpy copies all records: no per-element constructors, no heap
+    std::vector<FlatPerson> copy(people.size());
+    std::memcpy(copy.data(), people.data(), people.size() * sizeof(FlatPerson));
+    std::cout << "\nCopied via memcpy: " << copy[2].getName() << ", " << copy[2].age << '\n';
+
+    // ---------------------- WRITE + mmap BACK ------------------------
+    // The bytes in the file ARE the objects, so mapping them back is enough.
+    std::FILE *file = std::tmpfile();
+    int fd = fileno(file);
+    std::size_t bytes = people.size() * sizeof(FlatPerson);
+    if (write(fd, people.data(), bytes) == static_cast<ssize_t>(bytes))
+    {
+        void *mem = mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mem != MAP_FAILED)
+        {
+            const auto *mapped = static_cast<const FlatPerson *>(mem);
+            std::cout << "From mmap: ";
+            for (std::size_t i = 0; i < people.size(); i++)
+            {
+                std::cout << mapped[i].getName() << " ";
+            }
+            std::cout << '\n';
+            munmap(mem, bytes);
+        }
+    }
+    std::fclose(file);
+
+    return 0;
+}
+
+/*
+----------------------------------------------------------------------
+KEY TAKEAWAYS:
+----------------------------------------------------------------------
+1. std::string heap-allocates above its SSO limit (15 chars in libstdc++),
+   and because it holds a pointer it is NOT trivially copyable.
+
+2. FixedString<N> keeps the characters inline:
+   - constexpr constructible (see kDefaultName + static_assert)
+   - converts to std::string_view for free
+   - trivially copyable, so structs built from it can be memcpy'd,
+     written to disk and mmapped back as-is.
+   - Trade-off: fixed capacity. Choose N from your data (and check it!).
+
+3. Overloading on `const std::string&` and `std::string&&` lets callers
+   that pass temporaries (or std::move) avoid a character copy.
+
+4. For a std::string_view setter, no temporary std::string is created for
+   literals — the characters go straight into the inline buffer.
+
+- How to Run:
+    g++ 35fixed_string.cpp -o fixed --std=c++20
+----------------------------------------------------------------------
+*/
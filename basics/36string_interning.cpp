@@ -0,0 +1,303 @@
+#include <iostream>      // For std::cout
+#include <string>        // For std::string
+#include <string_view>   // For std::string_view (keys that point into the arena)
+#include <unordered_map> // For the per-shard hash map
+#include <vector>        // For id → string lookup and arena blocks
+#include <memory>        // For std::unique_ptr<char[]> arena blocks
+#include <mutex>         // For one lock per shard
+#include <thread>        // For the concurrent demo
+#include <array>         // For the fixed number of shards
+#include <cstdint>       // For uint32_t
+#include <cstring>       // For std::memcpy
+#include <functional>    // For std::hash<std::string_view>
+#include <stdexcept>     // For std::out_of_range, std::length_error
+
+/*
+----------------------------------------------------------------------
+TOPIC: STRING INTERNING (one copy of every distinct string)
+----------------------------------------------------------------------
+In 32struct_this_keyword.cpp every Person owns its own std::string.
+If a million people are called "Alice", we store "Alice" a million times,
+and comparing two names compares characters one by one.
+
+Interning = keep ONE copy of each distinct string in a table and hand out
+a small integer id for it:
+
+    intern("Alice") → 7
+    intern("Bob")   → 12
+    intern("Alice") → 7   (same id again, nothing new is stored)
+
+Now a Person stores a 4-byte id instead of a 32-byte std::string, and
+`a.name == b.name` is ONE integer comparison.
+
+Design used here:
+- Arena: characters are appended into big blocks that never move,
+  so std::string_view pointing into them stays valid forever.
+- Sharding: the table is split into 16 independent shards, each with its
+  own mutex. Threads interning different strings rarely hit the same lock.
+- Id layout: low 4 bits = shard, remaining 28 bits = index inside the shard.
+  All bits set (UINT32_MAX) is reserved as "no name".
+----------------------------------------------------------------------
+*/
+
+// ------------------------ ARENA -----------------------------
+
+/*
+Bump allocator for characters. Allocating is just "advance an offset".
+Nothing is freed individually; everything goes away with the arena.
+*/
+class StringArena
+{
+public:
+    std::string_view store(std::string_view s)
+    {
+        if (s.size() > capacity_ - used_)
+        {
+            // Oversized strings get a block of their own
+            std::size_t size = std::max(kBlockSize, s.size());
+            blocks_.push_back(std::make_unique<char[]>(size));
+            used_ = 0;
+            capacity_ = size;
+        }
+        char *dst = blocks_.back().get() + used_;
+        std::memcpy(dst, s.data(), s.size());
+        used_ += s.size();
+        bytes_ += s.size();
+        return std::string_view(dst, s.size());
+    }
+
+    std::size_t bytes() const { return bytes_; }
+
+private:
+    static constexpr std::size_t kBlockSize = 64 * 1024;
+
+    std::vector<std::unique_ptr<char[]>> blocks_;
+    std::size_t used_ = 0;
+    std::size_t capacity_ = 0; // 0 forces a block on first store
+    std::size_t bytes_ = 0;
+};
+
+// ------------------------ HANDLE -----------------------------
+
+// A strong type around uint32_t so a NameId can't be mixed up with an age
+struct NameId
+{
+    // 0 is a real id (shard 0, index 0), so "no name" needs its own value
+    static constexpr uint32_t kInvalid = UINT32_MAX;
+
+    uint32_t value = kInvalid;
+
+    bool valid() const { return value != kInvalid; }
+
+    bool operator==(const NameId &rhs) const { return value == rhs.value; }
+    bool operator!=(const NameId &rhs) const { return value != rhs.value; }
+};
+
+// ------------------------ SHARDED INTERN TABLE -----------------------------
+
+class InternTable
+{
+public:
+    static constexpr uint32_t kShardBits = 4;
+    static constexpr uint32_t kShards = 1u << kShardBits;
+    // Indices that survive `<< kShardBits`, minus the one that would form kInvalid
+    static constexpr std::size_t kMaxPerShard = (std::size_t{1} << (32 - kShardBits)) - 1;
+
+    // Returns the id for s, inserting it on first sight. Thread safe.
+    NameId intern(std::string_view s)
+    {
+        std::size_t h = std::hash<std::string_view>{}(s);
+        uint32_t shard_index = static_cast<uint32_t>(h & (kShards - 1));
+        Shard &shard = shards_[shard_index];
+
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.ids.find(s);
+        if (it != shard.ids.end())
+        {
+            return it->second;
+        }
+
+        if (shard.strings.size() >= kMaxPerShard)
+        {
+            // The index would wrap into another shard's ids
+            throw std::length_error("InternTable: shard is full");
+        }
+
+        // The key MUST point at the arena copy, not at the caller's memory
+        std::string_view stored = shard.arena.store(s);
+        NameId id{static_cast<uint32_t>(shard.strings.size() << kShardBits) | shard_index};
+        shard.strings.push_back(stored);
+        shard.ids.emplace(stored, id);
+        return id;
+    }
+
+    // Id → characters. Views stay valid as long as the table lives.
+    // Throws for the invalid id and for ids this table never handed out.
+    std::string_view lookup(NameId id) const
+    {
+        if (!id.valid())
+        {
+            throw std::out_of_range("InternTable: lookup of an invalid NameId");
+        }
+        const Shard &shard = shards_[id.value & (kShards - 1)];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        std::size_t index = id.value >> kShardBits;
+        if (index >= shard.strings.size())
+        {
+            throw std::out_of_range("InternTable: unknown NameId");
+        }
+        return shard.strings[index];
+    }
+
+    std::size_t size() const
+    {
+        std::size_t n = 0;
+        for (const auto &shard : shards_)
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            n += shard.strings.size();
+        }
+        return n;
+    }
+
+    std::size_t arena_bytes() const
+    {
+        std::size_t n = 0;
+        for (const auto &shard : shards_)
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            n += shard.arena.bytes();
+        }
+        return n;
+    }
+
+private:
+    // alignas(64): each shard's mutex sits on its own cache line
+    struct alignas(64) Shard
+    {
+        mutable std::mutex mutex;
+        std::unordered_map<std::string_view, NameId> ids;
+        std::vector<std::string_view> strings; // index → view into arena
+        StringArena arena;
+    };
+
+    std::array<Shard, kShards> shards_;
+};
+
+// ------------------------ Person with an interned name -----------------------------
+
+/*
+Compare with Person in 32struct_this_keyword.cpp:
+- the name is a 4-byte handle instead of a std::string
+- getName needs the table to turn the handle back into characters
+*/
+struct Person
+{
+    NameId name; // invalid until setName
+
+    Person &setName(InternTable &table, std::string_view newName)
+    {
+        this->name = table.intern(newName);
+        return *this;
+    }
+
+    std::string_view getName(const InternTable &table) const
+    {
+        return table.lookup(this->name);
+    }
+
+    bool sameName(const Person &other) const
+    {
+        // integer compare, O(1); two unnamed people don't share a name
+        return this->name.valid() && this->name == other.name;
+    }
+};
+
+int main()
+{
+    InternTable table;
+
+    // ---------------------- BASIC USAGE ------------------------
+    Person a, b, c;
+    a.setName(table, "Alice");
+    b.setName(table, std::string("Alice")); // different buffer, same id
+    c.setName(table, "Bob");
+
+    std::cout << "a == b ? " << a.sameName(b) << '\n'; // 1
+    std::cout << "a == c ? " << a.sameName(c) << '\n'; // 0
+    std::cout << "c's name: " << c.getName(table) << '\n';
+
+    Person nobody; // default id is invalid, not "the first string in shard 0"
+    std::cout << "nobody == a ? " << nobody.sameName(a) << '\n'; // 0
+    try
+    {
+        nobody.getName(table);
+    }
+    catch (const std::out_of_range &e)
+    {
+        std::cout << "nobody's name: " << e.what() << "\n\n";
+    }
+
+    // ---------------------- MANY THREADS, DUPLICATED NAMES ------------------------
+    const char *first_names[] = {"Alice", "Bob", "Charlie", "Dana", "Eve", "Frank",
+                                 "Grace", "Heidi", "Ivan", "Judy", "Mallory", "Oscar"};
+    constexpr int kPeople = 400000;
+    constexpr int kThreads = 4;
+
+    std::vector<Person> people(kPeople);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < kThreads; t++)
+    {
+        workers.emplace_back([&, t]
+                             {
+            for (int i = t; i < kPeople; i += kThreads)
+            {
+                // Only a few hundred distinct names across 400k people
+                std::string name = std::string(first_names[i % 12]) + " #" + std::to_string(i % 50);
+                people[i].setName(table, name);
+            } });
+    }
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+
+    // ---------------------- MEMORY COMPARISON ------------------------
+    std::size_t interned = people.size() * sizeof(Person) + table.arena_bytes();
+    std::size_t as_strings = people.size() * sizeof(std::string); // names fit SSO, so no heap on top
+
+    std::cout << "People:          " << people.size() << '\n';
+    std::cout << "Distinct names:  " << table.size() << '\n';
+    std::cout << "std::string:     " << as_strings / 1024 << " KB\n";
+    std::cout << "Interned:        " << interned / 1024 << " KB (handles + arena)\n";
+    std::cout << "people[7]:       " << people[7].getName(table) << '\n';
+
+    return 0;
+}
+
+/*
+----------------------------------------------------------------------
+KEY TAKEAWAYS:
+----------------------------------------------------------------------
+1. Interning stores each distinct string ONCE and replaces it with an id.
+   - Memory: 4 bytes per row instead of sizeof(std::string) (32 bytes)
+     plus possible heap allocation.
+   - Equality: integer compare instead of character compare.
+
+2. The hash map keys are std::string_view. That's only safe because the
+   views point into the arena, whose blocks are never moved or freed.
+
+3. Sharding: a single mutex would serialize every thread. With 16 shards,
+   two threads only contend if their strings hash to the same shard.
+
+4. Trade-offs:
+   - Strings are never removed (fine for name columns, not for random text).
+   - Ids are only meaningful together with THEIR table.
+   - Ordering by id is NOT alphabetical ordering.
+   - Reserve an id for "no name" (UINT32_MAX here): a default of 0 would
+     silently be the first string of shard 0.
+
+- How to Run:
+    g++ 36string_interning.cpp -o intern --std=c++20 -O2 -pthread
+----------------------------------------------------------------------
+*/
@@ -0,0 +1,267 @@
+#include <iostream>  // For std::cout
+#include <vector>    // For std::vector storage
+#include <span>      // For std::span views (see 24std_span.cpp)
+#include <tuple>     // For storing the chain of operations
+#include <utility>   // For std::index_sequence
+#include <chrono>    // For timing
+#include <cstddef>   // For std::size_t
+#include <stdexcept> // For std::length_error
+
+/*
+----------------------------------------------------------------------
+TOPIC: BATCHING CHAINED SETTERS WITH AN EXPRESSION TEMPLATE
+----------------------------------------------------------------------
+In 32struct_this_keyword.cpp we chain setters on ONE Point:
+
+    p.setX(10).setY(20);
+
+For millions of points filled from columns (xs[], ys[]) the naive way is:
+
+    for (i...) pts[i].setX(xs[i]);   // pass 1 over memory
+    for (i...) pts[i].setY(ys[i]);   // pass 2
+    for (i...) pts[i].translate(1,1) // pass 3
+
+k setters → k passes over the whole array → k times the memory traffic.
+
+Idea: make the chain RECORD the operations instead of running them:
+
+    batch(pts).setX(xs).setY(ys).translate(1, 1).run();
+
+Each call returns a NEW builder type that remembers one more operation
+(`Batch<SetX>` → `Batch<SetX, SetY>` → ...). Nothing touches memory
+until run(), which does ONE loop and applies every operation to each
+point while it's already in a register / L1 cache.
+
+Because the whole chain is part of the TYPE, the compiler sees every
+operation at compile time and inlines them into one tight loop.
+----------------------------------------------------------------------
+*/
+
+struct Point
+{
+    int x = 0, y = 0;
+
+    Point &setX(int x)
+    {
+        this->x = x;
+        return *this;
+    }
+
+    Point &setY(int y)
+    {
+        this->y = y;
+        return *this;
+    }
+
+    Point &translate(int dx, int dy)
+    {
+        this->x += dx;
+        this->y += dy;
+        return *this;
+    }
+};
+
+// ------------------------ OPERATIONS -----------------------------
+
+/*
+Each operation is a tiny struct with:
+    void operator()(Point &p, std::size_t i) const
+`i` is the element index, so column sources can read xs[i].
+*/
+
+struct SetXColumn
+{
+    std::span<const int> xs;
+    void operator()(Point &p, std::size_t i) const { p.x = xs[i]; }
+};
+
+struct SetYColumn
+{
+    std::span<const int> ys;
+    void operator()(Point &p, std::size_t i) const { p.y = ys[i]; }
+};
+
+struct SetXValue
+{
+    int x;
+    void operator()(Point &p, std::size_t) const { p.x = x; }
+};
+
+struct SetYValue
+{
+    int y;
+    void operator()(Point &p, std::size_t) const { p.y = y; }
+};
+
+struct Translate
+{
+    int dx, dy;
+    void operator()(Point &p, std::size_t) const
+    {
+        p.x += dx;
+        p.y += dy;
+    }
+};
+
+// ------------------------ THE BUILDER -----------------------------
+
+template <typename... Ops>
+class Batch
+{
+public:
+    Batch(std::span<Point> points, std::tuple<Ops...> ops) : points_(points), ops_(ops) {}
+
+    // Every setter returns a Batch with one more operation in its type.
+    // Columns are checked here, once, so run() can index them without checks.
+    auto setX(std::span<const int> xs) const { return then(SetXColumn{checked(xs)}); }
+    auto setX(int x) const { return then(SetXValue{x}); }
+    auto setY(std::span<const int> ys) const { return then(SetYColumn{checked(ys)}); }
+    auto setY(int y) const { return then(SetYValue{y}); }
+    auto translate(int dx, int dy) const { return then(Translate{dx, dy}); }
+
+    // The single fused pass
+    void run() const
+    {
+        run_impl(std::index_sequence_for<Ops...>{});
+    }
+
+private:
+    std::span<const int> checked(std::span<const int> column) const
+    {
+        if (column.size() < points_.size())
+        {
+            throw std::length_error("Batch: column is shorter than the point array");
+        }
+        return column;
+    }
+
+    template <typename Op>
+    Batch<Ops..., Op> then(Op op) const
+    {
+        return Batch<Ops..., Op>(points_, std::tuple_cat(ops_, std::make_tuple(op)));
+    }
+
+    template <std::size_t... Is>
+    void run_impl(std::index_sequence<Is...>) const
+    {
+        const std::size_t n = points_.size();
+        Point *pts = points_.data();
+        for (std::size_t i = 0; i < n; i++)
+        {
+            Point p = pts[i];                // load once
+            (std::get<Is>(ops_)(p, i), ...); // fold expression: apply ops in order
+            pts[i] = p;                      // store once
+        }
+    }
+
+    std::span<Point> points_;
+    std::tuple<Ops...> ops_;
+};
+
+// Entry point: an empty chain over the given points
+inline Batch<> batch(std::span<Point> points)
+{
+    return Batch<>(points, std::tuple<>{});
+}
+
+// ------------------------ NAIVE VERSION FOR COMPARISON -----------------------------
+
+void naive_k_passes(std::span<Point> pts, std::span<const int> xs, std::span<const int> ys)
+{
+    for (std::size_t i = 0; i < pts.size(); i++)
+        pts[i].setX(xs[i]);
+    for (std::size_t i = 0; i < pts.size(); i++)
+        pts[i].setY(ys[i]);
+    for (std::size_t i = 0; i < pts.size(); i++)
+        pts[i].translate(1, 1);
+    for (std::size_t i = 0; i < pts.size(); i++)
+        pts[i].translate(-2, 3);
+}
+
+template <typename F>
+double time_ms(F &&f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+int main()
+{
+    // ---------------------- SMALL EXAMPLE ------------------------
+    std::vector<Point> pts(4);
+    std::vector<int> xs{1, 2, 3, 4};
+
+    batch(pts).setX(xs).setY(100).translate(10, 0).run();
+
+    for (const auto &p : pts)
+    {
+        std::cout << "(" << p.x << ", " << p.y << ") ";
+    }
+    std::cout << '\n';
+
+    std::vector<int> too_short{1, 2};
+    try
+    {
+        batch(pts).setX(too_short).run();
+    }
+    catch (const std::length_error &e)
+    {
+        std::cout << "short column rejected: " << e.what() << '\n';
+    }
+    std::cout << '\n';
+
+    // ---------------------- BENCHMARK: 4 passes vs 1 fused pass ------------------------
+    constexpr std::size_t kN = 10'000'000;
+    std::vector<Point> a(kN), b(kN);
+    std::vector<int> cx(kN), cy(kN);
+    for (std::size_t i = 0; i < kN; i++)
+    {
+        cx[i] = static_cast<int>(i);
+        cy[i] = static_cast<int>(kN - i);
+    }
+
+    double naive = time_ms([&]
+                           { naive_k_passes(a, cx, cy); });
+    double fused = time_ms([&]
+                           { batch(b).setX(cx).setY(cy).translate(1, 1).translate(-2, 3).run(); });
+
+    bool same = true;
+    for (std::size_t i = 0; i < kN; i++)
+    {
+        same = same && a[i].x == b[i].x && a[i].y == b[i].y;
+    }
+
+    std::cout << "10M points, 4 chained operations\n";
+    std::cout << "  naive (4 passes): " << naive << " ms\n";
+    std::cout << "  fused (1 pass):   " << fused << " ms\n";
+    std::cout << "  same result:      " << same << '\n';
+
+    return 0;
+}
+
+/*
+----------------------------------------------------------------------
+KEY TAKEAWAYS:
+----------------------------------------------------------------------
+1. Returning *this (32.cpp) chains calls on ONE object. Returning a NEW
+   builder TYPE that carries the operation lets us chain calls that describe
+   work on MANY objects without doing it yet.
+
+2. `Batch<Ops...>` + `std::tuple<Ops...>` stores the chain; the fold
+   expression `(std::get<Is>(ops_)(p, i), ...)` applies them in order.
+
+3. run() reads and writes each Point once, no matter how many setters
+   were chained → memory traffic goes from k passes to 1.
+
+4. Column sizes are validated when the chain is built, not per element
+   in the hot loop.
+
+5. Nothing happens until run(). Forgetting run() means no work is done —
+   that's the usual trade-off of lazy / deferred APIs.
+
+- How to Run:
+    g++ 37point_batch_builder.cpp -o batch --std=c++20 -O2
+----------------------------------------------------------------------
+*/
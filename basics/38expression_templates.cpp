@@ -0,0 +1,341 @@
+#include <iostream>  // For std::cout
+#include <vector>    // For owning storage
+#include <span>      // For non-owning leaves (see 24std_span.cpp)
+#include <chrono>    // For timing
+#include <cstddef>   // For std::size_t
+#include <stdexcept> // For std::length_error
+
+/*
+----------------------------------------------------------------------
+TOPIC: EXPRESSION TEMPLATES (fusing a + b * 2 - c into ONE loop)
+----------------------------------------------------------------------
+In 31struct_op_overloading.cpp, `Point operator+` returns a NEW Point.
+For single points that's perfect. Now imagine whole ARRAYS of numbers or
+Points with the same operators:
+
+    result = a + b * 2 - c;
+
+The naive overloads do:
+    tmp1   = b * 2        → loop 1, allocate tmp1
+    tmp2   = a + tmp1     → loop 2, allocate tmp2
+    result = tmp2 - c     → loop 3
+Three passes over memory and two temporary arrays.
+
+Expression templates: `a + b` does NOT compute anything. It returns a
+small object `Add<A, B>` that REMEMBERS "add a and b". Building the full
+expression gives a TYPE like
+
+    Sub< Add< A, Scale<B> >, C >
+
+and only when it's assigned to `result` do we run ONE loop:
+
+    for i: result[i] = a[i] + b[i] * 2 - c[i];
+
+No temporaries, one pass, and since the loop body is plain arithmetic
+on contiguous data the compiler can auto-vectorize it (SIMD) with -O3.
+----------------------------------------------------------------------
+*/
+
+// A Point like in 31.cpp, with the arithmetic the expressions need
+struct Point
+{
+    int x = 0;
+    int y = 0;
+
+    Point operator+(const Point &rhs) const { return Point{x + rhs.x, y + rhs.y}; }
+    Point operator-(const Point &rhs) const { return Point{x - rhs.x, y - rhs.y}; }
+    Point operator*(int k) const { return Point{x * k, y * k}; }
+    bool operator==(const Point &rhs) const { return x == rhs.x && y == rhs.y; }
+};
+
+// ------------------------ EXPRESSION BASE (CRTP) -----------------------------
+
+/*
+Every expression node derives from Expr<Itself>. This lets our operator+
+accept ONLY expression nodes, so it won't hijack `int + int` or `Point + Point`.
+*/
+template <typename Derived>
+struct Expr
+{
+    const Derived &self() const { return static_cast<const Derived &>(*this); }
+};
+
+// ------------------------ LEAF: a view over existing data -----------------------------
+
+template <typename T>
+struct Leaf : Expr<Leaf<T>>
+{
+    std::span<const T> data;
+
+    explicit Leaf(std::span<const T> d) : data(d) {}
+    T operator[](std::size_t i) const { return data[i]; }
+    std::size_t size() const { return data.size(); }
+};
+
+// ------------------------ NODES: remember the operation -----------------------------
+
+template <typename T>
+class Vec;
+
+/*
+How a node stores an operand. Vec<T> OWNS a std::vector, so copying it
+into a node would deep-copy the whole array: store a Leaf (a span) to it
+instead. Every other operand is a leaf or node, tiny, kept by value.
+*/
+template <typename E>
+struct Operand
+{
+    using type = E;
+    static const E &make(const E &e) { return e; }
+};
+
+template <typename T>
+struct Operand<Vec<T>>
+{
+    using type = Leaf<T>;
+    static Leaf<T> make(const Vec<T> &v) { return v.leaf(); }
+};
+
+template <typename E>
+using operand_t = typename Operand<E>::type;
+
+// A real check, not an assert: it must hold in -DNDEBUG release builds too
+inline void require_same_length(std::size_t a, std::size_t b, const char *what)
+{
+    if (a != b)
+    {
+        throw std::length_error(what);
+    }
+}
+
+template <typename L, typename R>
+struct Add : Expr<Add<L, R>>
+{
+    operand_t<L> lhs; // never an owning Vec: spans or other nodes only
+    operand_t<R> rhs;
+
+    Add(const L &l, const R &r) : lhs(Operand<L>::make(l)), rhs(Operand<R>::make(r))
+    {
+        require_same_length(lhs.size(), rhs.size(), "operands must have the same length");
+    }
+    auto operator[](std::size_t i) const { return lhs[i] + rhs[i]; }
+    std::size_t size() const { return lhs.size(); }
+};
+
+template <typename L, typename R>
+struct Sub : Expr<Sub<L, R>>
+{
+    operand_t<L> lhs;
+    operand_t<R> rhs;
+
+    Sub(const L &l, const R &r) : lhs(Operand<L>::make(l)), rhs(Operand<R>::make(r))
+    {
+        require_same_length(lhs.size(), rhs.size(), "operands must have the same length");
+    }
+    auto operator[](std::size_t i) const { return lhs[i] - rhs[i]; }
+    std::size_t size() const { return lhs.size(); }
+};
+
+template <typename E, typename S>
+struct Scale : Expr<Scale<E, S>>
+{
+    operand_t<E> expr;
+    S factor;
+
+    Scale(const E &e, S f) : expr(Operand<E>::make(e)), factor(f) {}
+    auto operator[](std::size_t i) const { return expr[i] * factor; }
+    std::size_t size() const { return expr.size(); }
+};
+
+// ------------------------ OPERATORS: build nodes, compute nothing -----------------------------
+
+template <typename L, typename R>
+Add<L, R> operator+(const Expr<L> &l, const Expr<R> &r) { return Add<L, R>(l.self(), r.self()); }
+
+template <typename L, typename R>
+Sub<L, R> operator-(const Expr<L> &l, const Expr<R> &r) { return Sub<L, R>(l.self(), r.self()); }
+
+template <typename E>
+Scale<E, int> operator*(const Expr<E> &e, int k) { return Scale<E, int>(e.self(), k); }
+
+// ------------------------ OWNING VECTOR: where evaluation happens -----------------------------
+
+template <typename T>
+class Vec : public Expr<Vec<T>>
+{
+public:
+    explicit Vec(std::size_t n) : data_(n) {}
+
+    T &operator[](std::size_t i) { return data_[i]; }
+    T operator[](std::size_t i) const { return data_[i]; }
+    std::size_t size() const { return data_.size(); }
+
+    // Use a Vec inside an expression as a cheap, non-owning leaf
+    Leaf<T> leaf() const { return Leaf<T>(data_); }
+
+    // THE fused loop: one pass, no temporaries
+    template <typename E>
+    Vec &operator=(const Expr<E> &expr)
+    {
+        const E &e = expr.self();
+        require_same_length(e.size(), size(), "expression length must match the destination");
+        T *out = data_.data();
+        const std::size_t n = size();
+#pragma GCC ivdep // promise: `out` doesn't overlap the inputs → vectorize freely
+        for (std::size_t i = 0; i < n; i++)
+        {
+            out[i] = e[i];
+        }
+        return *this;
+    }
+
+private:
+    std::vector<T> data_;
+};
+
+// ------------------------ NAIVE VERSION: one temporary per operator -----------------------------
+
+template <typename T>
+std::vector<T> naive_add(const std::vector<T> &a, const std::vector<T> &b)
+{
+    std::vector<T> out(a.size());
+    for (std::size_t i = 0; i < a.size(); i++)
+        out[i] = a[i] + b[i];
+    return out;
+}
+
+template <typename T>
+std::vector<T> naive_sub(const std::vector<T> &a, const std::vector<T> &b)
+{
+    std::vector<T> out(a.size());
+    for (std::size_t i = 0; i < a.size(); i++)
+        out[i] = a[i] - b[i];
+    return out;
+}
+
+template <typename T>
+std::vector<T> naive_scale(const std::vector<T> &a, int k)
+{
+    std::vector<T> out(a.size());
+    for (std::size_t i = 0; i < a.size(); i++)
+        out[i] = a[i] * k;
+    return out;
+}
+
+template <typename F>
+double time_ms(F &&f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+template <typename T, typename MakeValue>
+void benchmark(const char *label, std::size_t n, MakeValue make)
+{
+    std::vector<T> a(n), b(n), c(n);
+    for (std::size_t i = 0; i < n; i++)
+    {
+        a[i] = make(i);
+        b[i] = make(i * 3);
+        c[i] = make(i * 7);
+    }
+    Leaf<T> la(a), lb(b), lc(c);
+    Vec<T> fused(n);
+    std::vector<T> naive;
+
+    // Warm-up so both versions see faulted-in pages for their outputs
+    fused = la + lb * 2 - lc;
+
+    double naive_ms = time_ms([&]
+                              { naive = naive_sub(naive_add(a, naive_scale(b, 2)), c); });
+    double fused_ms = time_ms([&]
+                              { fused = la + lb * 2 - lc; });
+
+    bool same = true;
+    for (std::size_t i = 0; i < n; i++)
+    {
+        same = same && fused[i] == naive[i];
+    }
+
+    std::cout << label << " (" << n / 1'000'000 << "M elements)\n"
+              << "  naive (3 loops, 2 temporaries): " << naive_ms << " ms\n"
+              << "  expression template (1 loop):   " << fused_ms << " ms\n"
+              << "  same result: " << same << '\n';
+}
+
+int main()
+{
+    // ---------------------- SMALL EXAMPLE ------------------------
+    std::vector<int> a{1, 2, 3}, b{10, 20, 30}, c{5, 5, 5};
+    Vec<int> result(3);
+
+    auto expr = Leaf<int>(a) + Leaf<int>(b) * 2 - Leaf<int>(c); // nothing computed yet
+    result = expr;                                              // one loop runs here
+
+    std::cout << "a + b * 2 - c = ";
+    for (std::size_t i = 0; i < result.size(); i++)
+    {
+        std::cout << result[i] << " "; // 16 37 58
+    }
+    std::cout << "\n\n";
+
+    // Same expression, but the elements are Points
+    std::vector<Point> pa{{1, 1}, {2, 2}}, pb{{10, 0}, {0, 10}}, pc{{1, 1}, {1, 1}};
+    Vec<Point> presult(2);
+    presult = Leaf<Point>(pa) + Leaf<Point>(pb) * 2 - Leaf<Point>(pc);
+    std::cout << "Points: (" << presult[0].x << ", " << presult[0].y << ") ("
+              << presult[1].x << ", " << presult[1].y << ")\n";
+
+    // Vecs can appear directly: the node stores a span to them, not a copy
+    Vec<int> va(1'000'000), vb(1'000'000), vsum(1'000'000);
+    auto vexpr = va + vb * 2;
+    std::cout << "sizeof(va + vb * 2) = " << sizeof(vexpr) << " bytes (two spans + a factor)\n\n";
+    vsum = vexpr;
+    try
+    {
+        Vec<int> shorter(10);
+        vsum = va + shorter; // checked even with -DNDEBUG
+    }
+    catch (const std::length_error &e)
+    {
+        std::cout << "Rejected: " << e.what() << "\n\n";
+    }
+
+    // ---------------------- BENCHMARK ------------------------
+    constexpr std::size_t kN = 10'000'000;
+    benchmark<int>("int", kN, [](std::size_t i)
+                   { return static_cast<int>(i); });
+    benchmark<Point>("Point", kN, [](std::size_t i)
+                     { return Point{static_cast<int>(i), static_cast<int>(i / 2)}; });
+
+    return 0;
+}
+
+/*
+----------------------------------------------------------------------
+KEY TAKEAWAYS:
+----------------------------------------------------------------------
+1. Operators don't have to compute. Here they build a tree of tiny
+   objects (Add, Sub, Scale) whose TYPE describes the whole expression.
+
+2. The work happens once, in Vec::operator=(const Expr<E>&), as a single
+   loop that calls e[i] — which the compiler inlines into
+   a[i] + b[i] * 2 - c[i].
+
+3. CRTP (`struct Add : Expr<Add<L, R>>`) restricts our operator+ to
+   expression types, so normal `int + int` and `Point + Point` are untouched.
+
+4. Nodes hold leaves BY VALUE (a span is just pointer + size). An owning
+   Vec is turned into a Leaf first (the Operand trait), so `vec + vec`
+   never copies a std::vector. Never let an expression outlive the arrays
+   it views — same rule as std::span.
+
+5. SIMD: the fused loop is branch-free, contiguous arithmetic, so
+   `-O3 -march=native` auto-vectorizes it. Check with -fopt-info-vec.
+
+- How to Run:
+    g++ 38expression_templates.cpp -o expr --std=c++20 -O3 -march=native
+----------------------------------------------------------------------
+*/
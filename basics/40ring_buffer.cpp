@@ -0,0 +1,495 @@
+#include <iostream>  // For std::cout
+#include <atomic>    // For lock-free head/tail indices
+#include <memory>    // For std::unique_ptr<int[]> payloads, std::construct_at / destroy_at
+#include <new>       // For ::operator new with std::align_val_t
+#include <vector>    // For storage and thread lists
+#include <span>      // For batched push/pop (see 24std_span.cpp)
+#include <thread>    // For producers and consumers
+#include <chrono>    // For throughput / latency timing
+#include <optional>  // For pop() that may find nothing
+#include <utility>   // For std::move
+#include <algorithm> // For std::min
+#include <cstddef>   // For std::size_t
+
+/*
+----------------------------------------------------------------------
+TOPIC: LOCK-FREE RING BUFFERS (passing data between threads)
+----------------------------------------------------------------------
+A ring buffer is a fixed-size array used as a queue: a producer writes at
+`tail`, a consumer reads at `head`, and both wrap around at the end.
+
+    [ . . A B C D . . ]
+          ^head   ^tail
+
+1. SPSC (single producer, single consumer)
+   - Only the producer writes `tail`, only the consumer writes `head`.
+   - So no locks and no compare-and-swap are needed, only atomic
+     loads/stores with acquire/release ordering.
+   - head and tail sit on DIFFERENT cache lines (alignas(64)). Otherwise
+     every write by one thread would invalidate the other thread's cache
+     line ("false sharing") even though they touch different variables.
+
+2. MPMC (multi producer, multi consumer)
+   - Several threads race for the same slot, so each slot carries a
+     sequence number and threads claim positions with compare_exchange.
+     (This is the well-known bounded queue design by Dmitry Vyukov.)
+
+Both queues MOVE elements in and out (see 33move.cpp). Sending a
+std::unique_ptr<int[]> only moves the pointer — the array is never copied.
+Slots are raw storage: an element is constructed when pushed and
+destroyed when popped, so T needs no default constructor.
+----------------------------------------------------------------------
+*/
+
+constexpr std::size_t kCacheLine = 64;
+
+// ------------------------ SPSC RING -----------------------------
+
+template <typename T>
+class SpscRing
+{
+public:
+    // capacity is rounded up to a power of two so `index & mask` replaces `%`
+    explicit SpscRing(std::size_t capacity)
+    {
+        std::size_t size = 1;
+        while (size < capacity)
+        {
+            size <<= 1;
+        }
+        // Raw, correctly aligned storage: no T exists until it is pushed
+        slots_ = static_cast<T *>(::operator new(size * sizeof(T), std::align_val_t{alignof(T)}));
+        mask_ = size - 1;
+    }
+
+    SpscRing(const SpscRing &) = delete;
+    SpscRing &operator=(const SpscRing &) = delete;
+
+    ~SpscRing()
+    {
+        // Destroy whatever is still queued, then release the storage
+        for (std::size_t i = head_.load(); i != tail_.load(); i++)
+        {
+            std::destroy_at(slots_ + (i & mask_));
+        }
+        ::operator delete(slots_, std::align_val_t{alignof(T)});
+    }
+
+    bool try_push(T &&value)
+    {
+        std::size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - cached_head_ > mask_) // looks full: refresh our copy of head
+        {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            if (tail - cached_head_ > mask_)
+            {
+                return false;
+            }
+        }
+        std::construct_at(slots_ + (tail & mask_), std::move(value));
+        tail_.store(tail + 1, std::memory_order_release); // publish the slot
+        return true;
+    }
+
+    std::optional<T> try_pop()
+    {
+        std::size_t head = head_.load(std::memory_order_relaxed);
+        if (head == cached_tail_)
+        {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            if (head == cached_tail_)
+            {
+                return std::nullopt;
+            }
+        }
+        T *slot = slots_ + (head & mask_);
+        T value = std::move(*slot);
+        std::destroy_at(slot);
+        head_.store(head + 1, std::memory_order_release); // give the slot back
+        return value;
+    }
+
+    // Batched versions: ONE atomic publish for many elements.
+    // Return how many elements were actually moved.
+    std::size_t push_batch(std::span<T> values)
+    {
+        std::size_t tail = tail_.load(std::memory_order_relaxed);
+        cached_head_ = head_.load(std::memory_order_acquire);
+        std::size_t free = mask_ + 1 - (tail - cached_head_);
+        std::size_t n = std::min(free, values.size());
+        for (std::size_t i = 0; i < n; i++)
+        {
+            std::construct_at(slots_ + ((tail + i) & mask_), std::move(values[i]));
+        }
+        tail_.store(tail + n, std::memory_order_release);
+        return n;
+    }
+
+    std::size_t pop_batch(std::span<T> out)
+    {
+        std::size_t head = head_.load(std::memory_order_relaxed);
+        cached_tail_ = tail_.load(std::memory_order_acquire);
+        std::size_t n = std::min(cached_tail_ - head, out.size());
+        for (std::size_t i = 0; i < n; i++)
+        {
+            T *slot = slots_ + ((head + i) & mask_);
+            out[i] = std::move(*slot);
+            std::destroy_at(slot);
+        }
+        head_.store(head + n, std::memory_order_release);
+        return n;
+    }
+
+private:
+    T *slots_ = nullptr; // mask_ + 1 slots; only [head, tail) hold live objects
+    std::size_t mask_ = 0;
+
+    // Consumer side: written by the consumer only
+    alignas(kCacheLine) std::atomic<std::size_t> head_{0};
+    std::size_t cached_tail_ = 0; // consumer's last seen tail (saves cache traffic)
+
+    // Producer side: written by the producer only
+    alignas(kCacheLine) std::atomic<std::size_t> tail_{0};
+    std::size_t cached_head_ = 0;
+};
+
+// ------------------------ MPMC RING -----------------------------
+
+template <typename T>
+class MpmcRing
+{
+public:
+    explicit MpmcRing(std::size_t capacity)
+    {
+        std::size_t size = 1;
+        while (size < capacity)
+        {
+            size <<= 1;
+        }
+        slots_ = std::make_unique<Slot[]>(size);
+        mask_ = size - 1;
+        for (std::size_t i = 0; i < size; i++)
+        {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpmcRing(const MpmcRing &) = delete;
+    MpmcRing &operator=(const MpmcRing &) = delete;
+
+    ~MpmcRing()
+    {
+        // No other thread may use the ring now: [head, tail) are all written
+        for (std::size_t i = head_.load(); i != tail_.load(); i++)
+        {
+            std::destroy_at(slots_[i & mask_].get());
+        }
+    }
+
+    bool try_push(T &&value)
+    {
+        std::size_t pos = tail_.load(std::memory_order_relaxed);
+        while (true)
+        {
+            Slot &slot = slots_[pos & mask_];
+            std::size_t seq = slot.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+            if (diff == 0) // slot is free for position `pos`: try to claim it
+            {
+                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    std::construct_at(slot.get(), std::move(value));
+                    slot.sequence.store(pos + 1, std::memory_order_release); // now readable
+                    return true;
+                }
+            }
+            else if (diff < 0) // the consumer hasn't freed it yet → full
+            {
+                return false;
+            }
+            else // another producer took it; reload and retry
+            {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    std::optional<T> try_pop()
+    {
+        std::size_t pos = head_.load(std::memory_order_relaxed);
+        while (true)
+        {
+            Slot &slot = slots_[pos & mask_];
+            std::size_t seq = slot.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+            if (diff == 0)
+            {
+                if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    T value = std::move(*slot.get());
+                    std::destroy_at(slot.get());
+                    slot.sequence.store(pos + mask_ + 1, std::memory_order_release); // free for next lap
+                    return value;
+                }
+            }
+            else if (diff < 0) // nothing written here yet → empty
+            {
+                return std::nullopt;
+            }
+            else
+            {
+                pos = head_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+private:
+    struct Slot
+    {
+        std::atomic<std::size_t> sequence{0};
+        alignas(T) std::byte storage[sizeof(T)]; // holds a T only between push and pop
+
+        T *get() { return std::launder(reinterpret_cast<T *>(storage)); }
+    };
+
+    std::unique_ptr<Slot[]> slots_;
+    std::size_t mask_ = 0;
+    alignas(kCacheLine) std::atomic<std::size_t> head_{0};
+    alignas(kCacheLine) std::atomic<std::size_t> tail_{0};
+};
+
+// ------------------------ BENCHMARK HELPERS -----------------------------
+
+using Clock = std::chrono::steady_clock;
+
+double seconds_since(Clock::time_point start)
+{
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// One producer → one consumer, single-element push/pop
+double spsc_throughput(std::size_t count)
+{
+    SpscRing<std::size_t> ring(1024);
+    auto start = Clock::now();
+    std::thread producer([&]
+                         {
+        for (std::size_t i = 0; i < count; i++)
+        {
+            std::size_t v = i;
+            while (!ring.try_push(std::move(v)))
+            {
+                std::this_thread::yield();
+            }
+        } });
+    std::size_t received = 0, sum = 0;
+    while (received < count)
+    {
+        if (auto v = ring.try_pop())
+        {
+            sum += *v;
+            received++;
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    double elapsed = seconds_since(start);
+    if (sum != count * (count - 1) / 2)
+    {
+        std::cout << "SPSC lost or reordered items!\n";
+    }
+    return count / elapsed / 1e6;
+}
+
+// Same, but moving 64 elements per atomic publish
+double spsc_batched_throughput(std::size_t count)
+{
+    SpscRing<std::size_t> ring(1024);
+    auto start = Clock::now();
+    std::thread producer([&]
+                         {
+        std::vector<std::size_t> batch(64);
+        for (std::size_t i = 0; i < count; i += batch.size())
+        {
+            for (std::size_t j = 0; j < batch.size(); j++)
+            {
+                batch[j] = i + j;
+            }
+            std::span<std::size_t> rest(batch);
+            while (!rest.empty())
+            {
+                std::size_t pushed = ring.push_batch(rest);
+                if (pushed == 0)
+                {
+                    std::this_thread::yield();
+                }
+                rest = rest.subspan(pushed);
+            }
+        } });
+    std::vector<std::size_t> out(64);
+    std::size_t received = 0;
+    while (received < count)
+    {
+        std::size_t popped = ring.pop_batch(out);
+        if (popped == 0)
+        {
+            std::this_thread::yield();
+        }
+        received += popped;
+    }
+    producer.join();
+    return count / seconds_since(start) / 1e6;
+}
+
+// N producers → N consumers through ONE shared MPMC queue
+double mpmc_throughput(std::size_t count, unsigned pairs)
+{
+    MpmcRing<std::size_t> ring(1024);
+    std::atomic<std::size_t> received{0};
+    std::size_t per_producer = count / pairs;
+    std::size_t total = per_producer * pairs;
+
+    auto start = Clock::now();
+    std::vector<std::thread> threads;
+    for (unsigned p = 0; p < pairs; p++)
+    {
+        threads.emplace_back([&]
+                             {
+            for (std::size_t i = 0; i < per_producer; i++)
+            {
+                std::size_t v = i;
+                while (!ring.try_push(std::move(v)))
+                {
+                    std::this_thread::yield();
+                }
+            } });
+        threads.emplace_back([&]
+                             {
+            while (received.load(std::memory_order_relaxed) < total)
+            {
+                if (ring.try_pop())
+                {
+                    received.fetch_add(1, std::memory_order_relaxed);
+                }
+                else
+                {
+                    std::this_thread::yield();
+                }
+            } });
+    }
+    for (auto &t : threads)
+    {
+        t.join();
+    }
+    return total / seconds_since(start) / 1e6;
+}
+
+// Ping-pong between two SPSC rings: round trip / 2 = one-way latency
+double spsc_latency_ns(std::size_t rounds)
+{
+    SpscRing<int> ping(16), pong(16);
+    std::thread echo([&]
+                     {
+        for (std::size_t i = 0; i < rounds; i++)
+        {
+            std::optional<int> v;
+            while (!(v = ping.try_pop()))
+            {
+                std::this_thread::yield();
+            }
+            while (!pong.try_push(std::move(*v)))
+            {
+                std::this_thread::yield();
+            }
+        } });
+    auto start = Clock::now();
+    for (std::size_t i = 0; i < rounds; i++)
+    {
+        int v = static_cast<int>(i);
+        while (!ping.try_push(std::move(v)))
+        {
+            std::this_thread::yield();
+        }
+        while (!pong.try_pop())
+        {
+            std::this_thread::yield();
+        }
+    }
+    double total = seconds_since(start);
+    echo.join();
+    return total / rounds / 2 * 1e9;
+}
+
+int main()
+{
+    // ---------------------- MOVING OWNED ARRAYS, NO COPIES ------------------------
+    SpscRing<std::unique_ptr<int[]>> ring(4);
+
+    auto array = std::make_unique<int[]>(1'000'000);
+    array[0] = 42;
+    int *address = array.get();
+
+    ring.try_push(std::move(array)); // only the pointer moves
+    auto received = ring.try_pop();
+
+    std::cout << "Sent array is now null: " << (array == nullptr) << '\n';
+    std::cout << "Same buffer received:   " << (received->get() == address) << '\n';
+    std::cout << "received[0] = " << (*received)[0] << '\n';
+
+    // No default constructor needed: slots are raw storage until a push
+    struct NoDefault
+    {
+        explicit NoDefault(int v) : value(v) {}
+        int value;
+    };
+    MpmcRing<NoDefault> typed(4);
+    typed.try_push(NoDefault{7});
+    std::cout << "Non-default-constructible element: " << typed.try_pop()->value << "\n\n";
+
+    // ---------------------- THROUGHPUT & LATENCY ------------------------
+    unsigned hw = std::max(2u, std::thread::hardware_concurrency());
+    constexpr std::size_t kCount = 5'000'000;
+
+    std::cout << "SPSC 1→1 single:       " << spsc_throughput(kCount) << " M items/s\n";
+    std::cout << "SPSC 1→1 batched (64): " << spsc_batched_throughput(kCount) << " M items/s\n";
+    std::cout << "MPMC 1→1:              " << mpmc_throughput(kCount, 1) << " M items/s\n";
+    std::cout << "MPMC " << hw / 2 << "→" << hw / 2 << ":              "
+              << mpmc_throughput(kCount, hw / 2) << " M items/s\n";
+    std::cout << "SPSC one-way latency:  " << spsc_latency_ns(100'000) << " ns\n";
+
+    return 0;
+}
+
+/*
+----------------------------------------------------------------------
+KEY TAKEAWAYS:
+----------------------------------------------------------------------
+1. SPSC needs no locks: each index has exactly one writer.
+   - release store on publish, acquire load on observe → the element
+     written before the store is visible after the load.
+   - Each side caches the OTHER side's index and only re-reads the atomic
+     when the ring looks full/empty.
+
+2. alignas(64) puts head and tail on separate cache lines to avoid
+   false sharing between the producer and consumer cores.
+
+3. Batching (push_batch / pop_batch) pays for one atomic publish per
+   batch instead of per element.
+
+4. MPMC needs compare_exchange because several threads compete for the
+   same index; per-slot sequence numbers say whether a slot is ready.
+
+5. T is MOVED in and out. unique_ptr<int[]> (or MyArray from 33move.cpp)
+   travels through the queue without copying its payload.
+
+NOTE: the numbers depend heavily on core count. Waiting threads call
+std::this_thread::yield(); on a single core they simply take turns, so
+latency in particular looks much worse than on a real multi-core box.
+
+- How to Run:
+    g++ 40ring_buffer.cpp -o ring --std=c++20 -O2 -pthread
+----------------------------------------------------------------------
+*/
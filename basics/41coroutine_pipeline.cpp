@@ -0,0 +1,676 @@
+#include <iostream>           // For std::cout
+#include <coroutine>          // C++20 coroutine machinery
+#include <optional>           // For storing a coroutine's result
+#include <exception>          // For std::exception_ptr
+#include <memory>             // For std::shared_ptr (spawned task state)
+#include <atomic>             // For the spawn hand-off
+#include <semaphore>          // For sync_wait
+#include <mutex>              // For the scheduler queue
+#include <condition_variable> // For sleeping worker threads
+#include <thread>             // For worker threads
+#include <deque>              // For the run queue and in-flight stages
+#include <vector>             // For buffers
+#include <span>               // For chunks (see 24std_span.cpp)
+#include <numeric>            // For std::accumulate
+#include <chrono>             // For timing
+#include <cstdio>             // For std::tmpfile
+#include <utility>            // For std::exchange, std::move
+#include <stdexcept>          // For std::invalid_argument
+#include <system_error>       // For std::system_error (pread failures)
+#include <cerrno>             // For errno, EINTR
+
+#include <unistd.h> // pread, write, fileno
+
+/*
+----------------------------------------------------------------------
+TOPIC: C++20 COROUTINES FOR A PIPELINED ARRAY PROCESSOR
+----------------------------------------------------------------------
+Every example so far runs top to bottom inside main(). If we process a
+big file chunk by chunk:
+
+    read chunk 0 → sum chunk 0 → read chunk 1 → sum chunk 1 → ...
+
+the CPU idles while the disk reads, and the disk idles while we compute.
+We want the READ of chunk i+1 to overlap the COMPUTE of chunk i.
+
+A coroutine is a function that can PAUSE (co_await / co_yield) and be
+RESUMED later, possibly on another thread. That lets us write the
+pipeline as straight-line code while the work jumps between threads.
+
+Pieces built in this file:
+1. ThreadPool   - a multi-threaded scheduler; `co_await pool.schedule()`
+                  moves the current coroutine onto a worker thread.
+2. task<T>      - a lazy coroutine that produces one T. Awaiting it starts
+                  it and resumes us when it finishes.
+3. spawn(task)  - starts a task NOW and lets us await its result LATER.
+                  This is what gives us overlap.
+4. generator<T> - a coroutine that co_yields many values (here: chunks
+                  as std::span<const int>), pulled with a range-for.
+5. sync_wait    - blocks main() until a task is done.
+
+"Bounded buffering": at most `depth` chunks are in flight at once, so
+memory stays bounded no matter how big the input is.
+----------------------------------------------------------------------
+*/
+
+// ------------------------ SCHEDULER -----------------------------
+
+class ThreadPool
+{
+public:
+    explicit ThreadPool(unsigned threads)
+    {
+        for (unsigned i = 0; i < threads; i++)
+        {
+            workers_.emplace_back([this]
+                                  { run(); });
+        }
+    }
+
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        cv_.notify_all();
+        for (auto &worker : workers_)
+        {
+            worker.join();
+        }
+    }
+
+    void post(std::coroutine_handle<> h)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            queue_.push_back(h);
+        }
+        cv_.notify_one();
+    }
+
+    // `co_await pool.schedule();` → continue on a worker thread
+    auto schedule()
+    {
+        struct Awaiter
+        {
+            ThreadPool *pool;
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> h) const { pool->post(h); }
+            void await_resume() const noexcept {}
+        };
+        return Awaiter{this};
+    }
+
+private:
+    void run()
+    {
+        while (true)
+        {
+            std::coroutine_handle<> h;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait(lock, [this]
+                         { return stopping_ || !queue_.empty(); });
+                if (queue_.empty())
+                {
+                    return; // stopping and nothing left to do
+                }
+                h = queue_.front();
+                queue_.pop_front();
+            }
+            h.resume();
+        }
+    }
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<std::coroutine_handle<>> queue_;
+    bool stopping_ = false;
+    std::vector<std::thread> workers_;
+};
+
+// ------------------------ task<T> -----------------------------
+
+template <typename T>
+class task
+{
+public:
+    struct promise_type
+    {
+        std::optional<T> value;
+        std::exception_ptr error;
+        std::coroutine_handle<> continuation = std::noop_coroutine();
+
+        task get_return_object() { return task(handle::from_promise(*this)); }
+
+        // Lazy: the body doesn't run until someone co_awaits the task
+        std::suspend_always initial_suspend() noexcept { return {}; }
+
+        // When the body finishes, jump straight back to whoever awaited us
+        struct FinalAwaiter
+        {
+            bool await_ready() const noexcept { return false; }
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> h) noexcept
+            {
+                return h.promise().continuation;
+            }
+            void await_resume() const noexcept {}
+        };
+        FinalAwaiter final_suspend() noexcept { return {}; }
+
+        void return_value(T v) { value = std::move(v); }
+        void unhandled_exception() { error = std::current_exception(); }
+    };
+
+    using handle = std::coroutine_handle<promise_type>;
+
+    task(task &&other) noexcept : coro_(std::exchange(other.coro_, {})) {}
+    task(const task &) = delete;
+    ~task()
+    {
+        if (coro_)
+        {
+            coro_.destroy();
+        }
+    }
+
+    // Awaiting a task: remember who to resume, then start the task's body
+    bool await_ready() const noexcept { return false; }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting)
+    {
+        coro_.promise().continuation = awaiting;
+        return coro_;
+    }
+    T await_resume()
+    {
+        if (coro_.promise().error)
+        {
+            std::rethrow_exception(coro_.promise().error);
+        }
+        return std::move(*coro_.promise().value);
+    }
+
+private:
+    explicit task(handle h) : coro_(h) {}
+    handle coro_;
+};
+
+// ------------------------ FIRE-AND-FORGET DRIVER -----------------------------
+
+// A coroutine that starts immediately and cleans itself up when done.
+// Only used internally by spawn() and sync_wait().
+struct detached
+{
+    struct promise_type
+    {
+        detached get_return_object() { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+};
+
+// ------------------------ spawn: start now, await later -----------------------------
+
+template <typename T>
+class spawned
+{
+public:
+    struct State
+    {
+        std::optional<T> value;
+        std::exception_ptr error;            // set instead of value if the task threw
+        std::atomic<void *> waiter{nullptr}; // nullptr → nobody waiting yet, kDone → finished
+    };
+
+    explicit spawned(std::shared_ptr<State> s) : state_(std::move(s)) {}
+
+    bool await_ready() const noexcept { return state_->waiter.load(std::memory_order_acquire) == done(); }
+
+    // Returns false (don't suspend) if the task finished in the meantime
+    bool await_suspend(std::coroutine_handle<> h)
+    {
+        void *expected = nullptr;
+        return state_->waiter.compare_exchange_strong(expected, h.address(), std::memory_order_acq_rel);
+    }
+
+    T await_resume()
+    {
+        if (state_->error)
+        {
+            std::rethrow_exception(state_->error);
+        }
+        return std::move(*state_->value);
+    }
+
+    static void *done() { return reinterpret_cast<void *>(1); }
+
+private:
+    std::shared_ptr<State> state_;
+};
+
+template <typename T>
+detached run_spawned(task<T> t, std::shared_ptr<typename spawned<T>::State> state)
+{
+    try
+    {
+        state->value = co_await t;
+    }
+    catch (...)
+    {
+        state->error = std::current_exception(); // rethrown by whoever awaits the spawned
+    }
+    void *waiter = state->waiter.exchange(spawned<T>::done(), std::memory_order_acq_rel);
+    if (waiter != nullptr)
+    {
+        std::coroutine_handle<>::from_address(waiter).resume();
+    }
+}
+
+template <typename T>
+spawned<T> spawn(task<T> t)
+{
+    auto state = std::make_shared<typename spawned<T>::State>();
+    run_spawned(std::move(t), state);
+    return spawned<T>(state);
+}
+
+// ------------------------ sync_wait -----------------------------
+
+template <typename T>
+detached signal_when_done(task<T> &t, std::optional<T> &out, std::exception_ptr &error,
+                          std::binary_semaphore &done)
+{
+    try
+    {
+        out = co_await t;
+    }
+    catch (...)
+    {
+        error = std::current_exception();
+    }
+    done.release();
+}
+
+// Blocks until `t` finishes; an exception thrown inside the task is rethrown here
+template <typename T>
+T sync_wait(task<T> t)
+{
+    std::optional<T> out;
+    std::exception_ptr error;
+    std::binary_semaphore done{0};
+    signal_when_done(t, out, error, done);
+    done.acquire();
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
+    return std::move(*out);
+}
+
+// ------------------------ generator<T> -----------------------------
+
+template <typename T>
+class generator
+{
+public:
+    struct promise_type
+    {
+        const T *current = nullptr;
+
+        generator get_return_object() { return generator(handle::from_promise(*this)); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        std::suspend_always yield_value(const T &v)
+        {
+            current = &v;
+            return {};
+        }
+        void return_void() {}
+        void unhandled_exception() { throw; }
+    };
+
+    using handle = std::coroutine_handle<promise_type>;
+
+    struct iterator
+    {
+        handle coro;
+        iterator &operator++()
+        {
+            coro.resume();
+            return *this;
+        }
+        const T &operator*() const { return *coro.promise().current; }
+        bool operator==(std::default_sentinel_t) const { return coro.done(); }
+    };
+
+    generator(generator &&other) noexcept : coro_(std::exchange(other.coro_, {})) {}
+    ~generator()
+    {
+        if (coro_)
+        {
+            coro_.destroy();
+        }
+    }
+
+    iterator begin()
+    {
+        coro_.resume(); // run to the first co_yield
+        return iterator{coro_};
+    }
+    std::default_sentinel_t end() { return {}; }
+
+private:
+    explicit generator(handle h) : coro_(h) {}
+    handle coro_;
+};
+
+// ------------------------ PIPELINE STAGES -----------------------------
+
+struct Point
+{
+    int x = 0;
+    int y = 0;
+};
+
+void require_positive(std::size_t n, const char *what)
+{
+    if (n == 0)
+    {
+        throw std::invalid_argument(what);
+    }
+}
+
+// Split an in-memory array into fixed-size chunks, lazily
+generator<std::span<const int>> chunks(std::span<const int> all, std::size_t chunk_size)
+{
+    require_positive(chunk_size, "chunks: chunk_size must be > 0");
+    for (std::size_t offset = 0; offset < all.size(); offset += chunk_size)
+    {
+        co_yield all.subspan(offset, std::min(chunk_size, all.size() - offset));
+    }
+}
+
+// Stage: like sum_array in 11functions.cpp, but for any chunk, on a worker thread
+task<long long> sum_array(ThreadPool &pool, std::span<const int> chunk)
+{
+    co_await pool.schedule();
+    co_return std::accumulate(chunk.begin(), chunk.end(), 0LL);
+}
+
+/*
+Stage: read one chunk of ints from a file (runs on a worker thread).
+pread may return fewer bytes than asked even before EOF, so keep reading
+until the chunk is full or pread returns 0. Only a chunk that ends at
+EOF comes back short; an empty one means "past the end". Errors throw.
+*/
+task<std::vector<int>> read_chunk(ThreadPool &pool, int fd, std::size_t index, std::size_t chunk_size)
+{
+    co_await pool.schedule();
+    std::vector<int> buffer(chunk_size);
+    char *bytes = reinterpret_cast<char *>(buffer.data());
+    const std::size_t want = chunk_size * sizeof(int);
+    const off_t start = static_cast<off_t>(index * want);
+    std::size_t have = 0;
+    while (have < want)
+    {
+        ssize_t got = pread(fd, bytes + have, want - have, start + static_cast<off_t>(have));
+        if (got < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            throw std::system_error(errno, std::generic_category(), "read_chunk: pread");
+        }
+        if (got == 0)
+        {
+            break; // real end of file
+        }
+        have += static_cast<std::size_t>(got);
+    }
+    buffer.resize(have / sizeof(int));
+    co_return buffer;
+}
+
+// Stage: Point transform on a chunk, returns how many points it touched
+task<std::size_t> translate_points(ThreadPool &pool, std::span<Point> pts, int dx, int dy)
+{
+    co_await pool.schedule();
+    for (auto &p : pts)
+    {
+        p.x += dx;
+        p.y += dy;
+    }
+    co_return pts.size();
+}
+
+// ------------------------ PIPELINES -----------------------------
+
+// Truly serial baseline: read chunk i, sum it, only then read chunk i+1
+task<long long> file_sum_serial(ThreadPool &pool, int fd, std::size_t chunk_size)
+{
+    require_positive(chunk_size, "file_sum_serial: chunk_size must be > 0");
+    long long total = 0;
+    for (std::size_t index = 0;; index++)
+    {
+        std::vector<int> chunk = co_await read_chunk(pool, fd, index, chunk_size);
+        if (chunk.empty())
+        {
+            break; // end of file
+        }
+        total += co_await sum_array(pool, chunk);
+    }
+    co_return total;
+}
+
+/*
+read → sum, with up to `depth` reads in flight.
+While we sum chunk i, chunks i+1 .. i+depth are already being read.
+A failed read is rethrown, but only after the other reads have finished:
+they still use `fd` and `pool`, which the caller may tear down.
+*/
+task<long long> file_sum_pipeline(ThreadPool &pool, int fd, std::size_t chunk_size, std::size_t depth)
+{
+    require_positive(chunk_size, "file_sum_pipeline: chunk_size must be > 0");
+    require_positive(depth, "file_sum_pipeline: depth must be > 0");
+    std::deque<spawned<std::vector<int>>> in_flight; // the bounded buffer
+    std::size_t next = 0;
+    for (; next < depth; next++)
+    {
+        in_flight.push_back(spawn(read_chunk(pool, fd, next, chunk_size)));
+    }
+
+    long long total = 0;
+    std::exception_ptr error;
+    try
+    {
+        while (true)
+        {
+            std::vector<int> chunk = co_await in_flight.front();
+            in_flight.pop_front();
+            if (chunk.empty())
+            {
+                break; // end of file
+            }
+            in_flight.push_back(spawn(read_chunk(pool, fd, next++, chunk_size))); // refill
+            total += co_await sum_array(pool, chunk);
+        }
+    }
+    catch (...)
+    {
+        error = std::current_exception(); // can't co_await inside a catch block
+    }
+
+    // Drain reads that were issued past the end of the file (or after an error)
+    while (!in_flight.empty())
+    {
+        try
+        {
+            co_await in_flight.front();
+        }
+        catch (...)
+        {
+            // the first error is the one we report
+        }
+        in_flight.pop_front();
+    }
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
+    co_return total;
+}
+
+// generator → parallel sum, at most `depth` chunk sums running at once
+task<long long> memory_sum_pipeline(ThreadPool &pool, std::span<const int> data, std::size_t chunk_size,
+                                    std::size_t depth)
+{
+    require_positive(depth, "memory_sum_pipeline: depth must be > 0");
+    std::deque<spawned<long long>> in_flight;
+    long long total = 0;
+    for (std::span<const int> chunk : chunks(data, chunk_size))
+    {
+        if (in_flight.size() == depth)
+        {
+            total += co_await in_flight.front();
+            in_flight.pop_front();
+        }
+        in_flight.push_back(spawn(sum_array(pool, chunk)));
+    }
+    while (!in_flight.empty())
+    {
+        total += co_await in_flight.front();
+        in_flight.pop_front();
+    }
+    co_return total;
+}
+
+task<std::size_t> point_pipeline(ThreadPool &pool, std::span<Point> pts, std::size_t chunk_size)
+{
+    require_positive(chunk_size, "point_pipeline: chunk_size must be > 0");
+    std::vector<spawned<std::size_t>> jobs;
+    for (std::size_t offset = 0; offset < pts.size(); offset += chunk_size)
+    {
+        auto part = pts.subspan(offset, std::min(chunk_size, pts.size() - offset));
+        jobs.push_back(spawn(translate_points(pool, part, 1, -1)));
+    }
+    std::size_t touched = 0;
+    for (auto &job : jobs)
+    {
+        touched += co_await job;
+    }
+    co_return touched;
+}
+
+template <typename F>
+double time_ms(F &&f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+int main()
+{
+    ThreadPool pool(std::max(2u, std::thread::hardware_concurrency()));
+
+    // ---------------------- IN-MEMORY: generator + parallel sums ------------------------
+    std::vector<int> data(10'000'000);
+    std::iota(data.begin(), data.end(), 0);
+    long long expected = std::accumulate(data.begin(), data.end(), 0LL);
+
+    long long mem_total = 0;
+    double mem_ms = time_ms([&]
+                            { mem_total = sync_wait(memory_sum_pipeline(pool, data, 1 << 16, 8)); });
+    std::cout << "In-memory pipeline sum: " << mem_total << " (ok: " << (mem_total == expected)
+              << ") in " << mem_ms << " ms\n";
+
+    // ---------------------- FILE: read overlaps compute ------------------------
+    std::FILE *file = std::tmpfile();
+    int fd = fileno(file);
+    if (write(fd, data.data(), data.size() * sizeof(int)) != static_cast<ssize_t>(data.size() * sizeof(int)))
+    {
+        std::cout << "could not write temp file\n";
+        return 1;
+    }
+
+    long long serial = 0, depth1 = 0, depth4 = 0;
+    double serial_ms = time_ms([&]
+                               { serial = sync_wait(file_sum_serial(pool, fd, 1 << 16)); });
+    // depth 1 already overlaps: the next read starts before the current sum
+    double depth1_ms = time_ms([&]
+                               { depth1 = sync_wait(file_sum_pipeline(pool, fd, 1 << 16, 1)); });
+    double depth4_ms = time_ms([&]
+                               { depth4 = sync_wait(file_sum_pipeline(pool, fd, 1 << 16, 4)); });
+    std::cout << "File serial read→sum:   " << serial << " in " << serial_ms << " ms\n";
+    std::cout << "File pipeline depth 1:  " << depth1 << " in " << depth1_ms << " ms\n";
+    std::cout << "File pipeline depth 4:  " << depth4 << " in " << depth4_ms << " ms (all ok: "
+              << (serial == expected && depth1 == expected && depth4 == expected) << ")\n";
+
+    // Bad arguments and I/O errors surface as exceptions, not as a short sum
+    try
+    {
+        sync_wait(file_sum_pipeline(pool, fd, 1 << 16, 0));
+    }
+    catch (const std::invalid_argument &e)
+    {
+        std::cout << "Rejected: " << e.what() << '\n';
+    }
+    std::fclose(file);
+    try
+    {
+        sync_wait(file_sum_pipeline(pool, fd, 1 << 16, 4)); // fd is closed now → EBADF
+    }
+    catch (const std::system_error &e)
+    {
+        std::cout << "Read error propagated: " << e.what() << '\n';
+    }
+
+    // ---------------------- POINT TRANSFORM STAGE ------------------------
+    std::vector<Point> pts(1'000'000, Point{5, 5});
+    std::size_t touched = sync_wait(point_pipeline(pool, pts, 1 << 14));
+    std::cout << "Translated " << touched << " points, first = (" << pts[0].x << ", " << pts[0].y << ")\n";
+
+    return 0;
+}
+
+/*
+----------------------------------------------------------------------
+KEY TAKEAWAYS:
+----------------------------------------------------------------------
+1. A function becomes a coroutine as soon as it uses co_await, co_yield or
+   co_return. Its return type (task<T>, generator<T>) has a promise_type
+   that tells the compiler how to start, suspend, and finish it.
+
+2. `co_await pool.schedule()` suspends the coroutine and hands its handle
+   to a worker thread, which resumes it there. That's the whole scheduler.
+
+3. task<T> is LAZY (initial_suspend = suspend_always). spawn() starts it
+   immediately so work can run while we do something else, and an atomic
+   hand-off decides who resumes whom if the task finishes first.
+
+4. Overlap + bounded buffering: the pipeline keeps a deque of at most
+   `depth` in-flight stages. Even depth 1 overlaps (the next read starts
+   before the current chunk is summed), so compare against the truly
+   serial read → sum → read loop. Raising depth lets more reads run
+   ahead. Overlap needs idle resources: with the file in the page cache
+   (reads are memcpys) on a 1-core machine all three take the same time.
+
+5. generator<T> uses co_yield to produce a lazy sequence of chunks, and
+   works in a normal range-based for loop.
+
+6. Lifetimes matter: a span passed into a coroutine must outlive it,
+   exactly like with std::span anywhere else.
+
+7. Errors travel with the result: task, spawned and sync_wait store an
+   exception_ptr and rethrow it at co_await, so a failed pread reaches
+   main() instead of looking like end of file.
+
+- How to Run:
+    g++ 41coroutine_pipeline.cpp -o pipeline --std=c++20 -O2 -pthread
+----------------------------------------------------------------------
+*/
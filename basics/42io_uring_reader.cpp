@@ -0,0 +1,550 @@
+#include <iostream>  // For std::cout
+#include <fstream>   // For the std::ifstream baseline
+#include <memory>    // For std::unique_ptr with a free() deleter
+#include <vector>    // For worker threads and request tracking
+#include <span>      // For destination buffers (see 24std_span.cpp)
+#include <thread>    // For the pread fallback pool
+#include <atomic>    // For std::atomic_ref on the shared ring indices
+#include <chrono>    // For throughput timing
+#include <cstring>   // For std::memcpy, std::memset
+#include <cstdlib>   // For std::aligned_alloc, std::free
+#include <cstdint>   // For uint64_t
+#include <string>    // For file paths
+#include <algorithm> // For std::min
+#include <cstdio>    // For std::remove
+#include <cerrno>    // For errno, EINTR
+#include <climits>   // For UINT_MAX
+#include <stdexcept> // For std::invalid_argument
+
+#include <fcntl.h>          // open, O_DIRECT
+#include <unistd.h>         // read, pread, close, syscall
+#include <sys/mman.h>       // mmap for the ring buffers and the baseline
+#include <sys/stat.h>       // fstat
+#include <sys/syscall.h>    // SYS_io_uring_setup, SYS_io_uring_enter
+#include <linux/io_uring.h> // io_uring structs and constants (kernel header)
+
+/*
+----------------------------------------------------------------------
+TOPIC: BULK FILE LOADING WITH io_uring (and a pread fallback)
+----------------------------------------------------------------------
+So far input came from `cin` (02inputs_cin.cpp) and `argv` (02inputs.cpp).
+To load a multi-GB binary array from an NVMe drive the classic loop is
+
+    while (read(fd, buf, 1MB) > 0) ...
+
+which has only ONE request outstanding at a time. NVMe drives need many
+requests in flight (queue depth 32+) to reach their full bandwidth.
+
+io_uring (Linux 5.1+) is a pair of ring buffers shared between our
+process and the kernel:
+- Submission Queue (SQ): we write "read N bytes at offset X into buf".
+- Completion Queue (CQ): the kernel writes "request #7 done, 1 MB read".
+We can queue 32 reads, make ONE system call, and collect completions as
+they arrive. No liburing needed: we call the two syscalls directly.
+
+Where io_uring isn't available (old kernel, seccomp sandbox) we fall back
+to a small thread pool where each thread issues blocking pread() calls —
+that also keeps several requests in flight.
+
+O_DIRECT bypasses the page cache (data goes straight from the device into
+our buffer). It requires the buffer, offset and length to be aligned,
+usually to 4096 bytes, so we allocate with std::aligned_alloc.
+----------------------------------------------------------------------
+*/
+
+// ------------------------ ALIGNED BUFFER -----------------------------
+
+constexpr std::size_t kAlign = 4096;
+
+struct FreeDeleter
+{
+    void operator()(std::byte *p) const { std::free(p); }
+};
+
+using AlignedBuffer = std::unique_ptr<std::byte[], FreeDeleter>;
+
+AlignedBuffer make_aligned_buffer(std::size_t bytes)
+{
+    std::size_t rounded = (bytes + kAlign - 1) / kAlign * kAlign;
+    return AlignedBuffer(static_cast<std::byte *>(std::aligned_alloc(kAlign, rounded)));
+}
+
+// ------------------------ MINIMAL io_uring WRAPPER -----------------------------
+
+class IoUring
+{
+public:
+    ~IoUring()
+    {
+        if (sqes_ != nullptr)
+            munmap(sqes_, sqes_bytes_);
+        if (cq_ptr_ != nullptr && cq_ptr_ != sq_ptr_)
+            munmap(cq_ptr_, cq_bytes_);
+        if (sq_ptr_ != nullptr)
+            munmap(sq_ptr_, sq_bytes_);
+        if (ring_fd_ >= 0)
+            close(ring_fd_);
+    }
+
+    // Returns false if the kernel (or a sandbox) doesn't allow io_uring
+    bool init(unsigned entries)
+    {
+        io_uring_params params{};
+        ring_fd_ = static_cast<int>(syscall(SYS_io_uring_setup, entries, &params));
+        if (ring_fd_ < 0)
+        {
+            return false;
+        }
+
+        // Map the two rings and the SQE array into our address space
+        sq_bytes_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cq_bytes_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+        if (single_mmap)
+        {
+            sq_bytes_ = cq_bytes_ = std::max(sq_bytes_, cq_bytes_);
+        }
+
+        sq_ptr_ = mmap(nullptr, sq_bytes_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                       ring_fd_, IORING_OFF_SQ_RING);
+        if (sq_ptr_ == MAP_FAILED)
+        {
+            sq_ptr_ = nullptr;
+            return false;
+        }
+        cq_ptr_ = single_mmap ? sq_ptr_
+                              : mmap(nullptr, cq_bytes_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                     ring_fd_, IORING_OFF_CQ_RING);
+        if (cq_ptr_ == MAP_FAILED)
+        {
+            cq_ptr_ = nullptr;
+            return false;
+        }
+        sqes_bytes_ = params.sq_entries * sizeof(io_uring_sqe);
+        void *sqes = mmap(nullptr, sqes_bytes_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                          ring_fd_, IORING_OFF_SQES);
+        if (sqes == MAP_FAILED)
+        {
+            return false;
+        }
+        sqes_ = static_cast<io_uring_sqe *>(sqes);
+
+        auto *sq = static_cast<char *>(sq_ptr_);
+        sq_head_ = reinterpret_cast<unsigned *>(sq + params.sq_off.head);
+        sq_tail_ = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+        sq_mask_ = *reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+        sq_array_ = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+        sq_entries_ = params.sq_entries;
+
+        auto *cq = static_cast<char *>(cq_ptr_);
+        cq_head_ = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+        cq_tail_ = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+        cq_mask_ = *reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+        return true;
+    }
+
+    // Queue a read; nothing is sent to the kernel until submit_and_wait()
+    bool queue_read(int fd, void *buf, unsigned len, uint64_t offset, uint64_t user_data)
+    {
+        unsigned tail = *sq_tail_; // only we write the SQ tail
+        unsigned head = std::atomic_ref<unsigned>(*sq_head_).load(std::memory_order_acquire);
+        if (tail - head == sq_entries_)
+        {
+            return false; // submission queue full
+        }
+        unsigned index = tail & sq_mask_;
+        io_uring_sqe &sqe = sqes_[index];
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = IORING_OP_READ;
+        sqe.fd = fd;
+        sqe.addr = reinterpret_cast<uint64_t>(buf);
+        sqe.len = len;
+        sqe.off = offset;
+        sqe.user_data = user_data;
+        sq_array_[index] = index;
+        std::atomic_ref<unsigned>(*sq_tail_).store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /*
+    Submit everything queued and block until at least `wait_nr` completions
+    exist. A signal can interrupt the wait (EINTR): that is not a failure,
+    so retry. The count is re-read from the ring each time, so SQEs the
+    kernel already consumed before the interruption are not sent twice.
+    */
+    int submit_and_wait(unsigned wait_nr)
+    {
+        while (true)
+        {
+            unsigned to_submit = *sq_tail_ - std::atomic_ref<unsigned>(*sq_head_).load(std::memory_order_acquire);
+            int ret = static_cast<int>(syscall(SYS_io_uring_enter, ring_fd_, to_submit, wait_nr,
+                                               IORING_ENTER_GETEVENTS, nullptr, 0));
+            if (ret >= 0 || errno != EINTR)
+            {
+                return ret;
+            }
+        }
+    }
+
+    // Take one completion if available
+    bool pop_completion(io_uring_cqe &out)
+    {
+        unsigned head = *cq_head_; // only we write the CQ head
+        unsigned tail = std::atomic_ref<unsigned>(*cq_tail_).load(std::memory_order_acquire);
+        if (head == tail)
+        {
+            return false;
+        }
+        out = cqes_[head & cq_mask_];
+        std::atomic_ref<unsigned>(*cq_head_).store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    int ring_fd_ = -1;
+    void *sq_ptr_ = nullptr, *cq_ptr_ = nullptr;
+    std::size_t sq_bytes_ = 0, cq_bytes_ = 0, sqes_bytes_ = 0;
+    io_uring_sqe *sqes_ = nullptr;
+    io_uring_cqe *cqes_ = nullptr;
+    unsigned *sq_head_ = nullptr, *sq_tail_ = nullptr, *sq_array_ = nullptr;
+    unsigned *cq_head_ = nullptr, *cq_tail_ = nullptr;
+    unsigned sq_mask_ = 0, cq_mask_ = 0, sq_entries_ = 0;
+};
+
+// ------------------------ ASYNC READER -----------------------------
+
+struct ReadOptions
+{
+    std::size_t block_size = 1 << 20; // 1 MB per request
+    unsigned queue_depth = 32;        // requests in flight
+    bool direct = false;              // O_DIRECT (needs aligned buffer)
+    bool force_fallback = false;      // skip io_uring, use the pread pool
+};
+
+struct ReadResult
+{
+    std::size_t bytes = 0;
+    double seconds = 0;
+    const char *backend = "";
+    bool direct = false; // O_DIRECT was actually in effect
+    bool ok = false;
+
+    double gb_per_s() const { return seconds > 0 ? bytes / seconds / 1e9 : 0; }
+};
+
+// Zero threads or zero-byte blocks would "succeed" having read nothing (or divide by 0)
+void validate(const ReadOptions &opts)
+{
+    if (opts.queue_depth == 0)
+    {
+        throw std::invalid_argument("ReadOptions: queue_depth must be >= 1");
+    }
+    if (opts.block_size == 0 || opts.block_size > UINT_MAX) // an SQE length is 32 bits
+    {
+        throw std::invalid_argument("ReadOptions: block_size must be in [1, UINT_MAX]");
+    }
+}
+
+// Blocking preads from `threads` threads, each taking every N-th block
+bool pread_pool(int fd, std::span<std::byte> dest, std::size_t file_size, const ReadOptions &opts)
+{
+    validate(opts);
+    std::atomic<bool> ok{true};
+    std::vector<std::thread> workers;
+    std::size_t blocks = (file_size + opts.block_size - 1) / opts.block_size;
+    unsigned threads = std::min<unsigned>(opts.queue_depth, 8);
+    for (unsigned t = 0; t < threads; t++)
+    {
+        workers.emplace_back([&, t]
+                             {
+            for (std::size_t b = t; b < blocks; b += threads)
+            {
+                std::size_t offset = b * opts.block_size;
+                std::size_t len = std::min(opts.block_size, dest.size() - offset);
+                std::size_t done = 0;
+                while (done < len)
+                {
+                    ssize_t got = pread(fd, dest.data() + offset + done, len - done,
+                                        static_cast<off_t>(offset + done));
+                    if (got <= 0)
+                    {
+                        // 0 = EOF (last O_DIRECT block), < 0 = error. Only ever clear
+                        // the flag: another thread's error must not be overwritten.
+                        if (got < 0)
+                        {
+                            ok = false;
+                        }
+                        break;
+                    }
+                    done += static_cast<std::size_t>(got);
+                }
+            } });
+    }
+    for (auto &w : workers)
+    {
+        w.join();
+    }
+    return ok;
+}
+
+bool uring_read(IoUring &ring, int fd, std::span<std::byte> dest, std::size_t file_size, const ReadOptions &opts)
+{
+    validate(opts);
+    std::size_t blocks = (file_size + opts.block_size - 1) / opts.block_size;
+    std::vector<std::size_t> done(blocks, 0); // bytes completed per block
+    std::size_t next = 0, completed = 0, in_flight = 0;
+
+    auto queue_block = [&](std::size_t b)
+    {
+        std::size_t offset = b * opts.block_size + done[b];
+        std::size_t len = std::min(opts.block_size, dest.size() - b * opts.block_size) - done[b];
+        return ring.queue_read(fd, dest.data() + offset, static_cast<unsigned>(len), offset, b);
+    };
+
+    while (completed < blocks)
+    {
+        // Keep the queue full
+        while (next < blocks && in_flight < opts.queue_depth && queue_block(next))
+        {
+            next++;
+            in_flight++;
+        }
+        if (ring.submit_and_wait(1) < 0)
+        {
+            return false;
+        }
+        io_uring_cqe cqe;
+        while (ring.pop_completion(cqe))
+        {
+            in_flight--;
+            std::size_t b = cqe.user_data;
+            if (cqe.res < 0)
+            {
+                return false;
+            }
+            done[b] += static_cast<std::size_t>(cqe.res);
+            std::size_t want = std::min(opts.block_size, file_size - b * opts.block_size);
+            if (cqe.res == 0 || done[b] >= want)
+            {
+                completed++;
+            }
+            else if (queue_block(b)) // short read: ask for the rest
+            {
+                in_flight++;
+            }
+        }
+    }
+    return true;
+}
+
+/*
+Reads the whole file into `dest` (which must be at least file-size bytes,
+rounded up to kAlign when opts.direct is set).
+*/
+ReadResult read_file(const std::string &path, std::span<std::byte> dest, const ReadOptions &opts = {})
+{
+    validate(opts);
+    ReadResult result;
+    int flags = O_RDONLY | (opts.direct ? O_DIRECT : 0);
+    int fd = open(path.c_str(), flags);
+    result.direct = fd >= 0 && opts.direct;
+    if (fd < 0 && opts.direct)
+    {
+        fd = open(path.c_str(), O_RDONLY); // e.g. tmpfs doesn't support O_DIRECT
+    }
+    if (fd < 0)
+    {
+        return result;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0)
+    {
+        close(fd);
+        return result;
+    }
+    std::size_t file_size = static_cast<std::size_t>(st.st_size);
+    if (dest.size() < file_size)
+    {
+        close(fd);
+        return result;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    IoUring ring;
+    if (!opts.force_fallback && ring.init(opts.queue_depth))
+    {
+        result.backend = "io_uring";
+        result.ok = uring_read(ring, fd, dest, file_size, opts);
+    }
+    else
+    {
+        result.backend = "pread pool";
+        result.ok = pread_pool(fd, dest, file_size, opts);
+    }
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    result.bytes = file_size;
+    close(fd);
+    return result;
+}
+
+// ------------------------ BASELINES -----------------------------
+
+template <typename F>
+double time_s(F &&f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// The test file holds 0, 1, 2, ... as ints: check EVERY value, not just the last
+bool verify(std::span<const std::byte> data)
+{
+    std::span<const int> ints(reinterpret_cast<const int *>(data.data()), data.size() / sizeof(int));
+    for (std::size_t i = 0; i < ints.size(); i++)
+    {
+        if (ints[i] != static_cast<int>(i))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void report(const std::string &label, std::size_t bytes, double seconds, bool ok)
+{
+    std::cout << "  " << label << ": " << bytes / seconds / 1e9 << " GB/s" << (ok ? "" : " [FAILED]") << '\n';
+}
+
+int main(int argc, char *argv[])
+{
+    std::string path = argc > 1 ? argv[1] : "io_uring_test.bin";
+    std::size_t mb = argc > 2 ? std::stoul(argv[2]) : 256;
+    std::size_t bytes = mb << 20;
+
+    // ---------------------- CREATE TEST FILE ------------------------
+    {
+        std::vector<int> ints((1 << 20) / sizeof(int));
+        std::ofstream out(path, std::ios::binary);
+        for (std::size_t written = 0; written < bytes; written += 1 << 20)
+        {
+            for (std::size_t i = 0; i < ints.size(); i++)
+            {
+                ints[i] = static_cast<int>(written / sizeof(int) + i);
+            }
+            out.write(reinterpret_cast<const char *>(ints.data()), 1 << 20);
+        }
+    }
+    std::cout << "Test file " << path << " (" << mb << " MB)\n";
+    std::cout << "NOTE: the file is likely in the page cache; for cold numbers run\n"
+                 "      `echo 3 | sudo tee /proc/sys/vm/drop_caches` between runs.\n\n";
+
+    AlignedBuffer buffer = make_aligned_buffer(bytes);
+    std::span<std::byte> dest(buffer.get(), bytes);
+
+    // Zero the buffer before every run so one path can't pass on another's data
+    auto fresh = [&]
+    {
+        std::memset(dest.data(), 0, bytes);
+        return dest;
+    };
+
+    // ---------------------- ifstream ------------------------
+    fresh();
+    double t = time_s([&]
+                                        {
+        std::ifstream in(path, std::ios::binary);
+        in.read(reinterpret_cast<char *>(dest.data()), static_cast<std::streamsize>(bytes)); });
+    report("ifstream   ", bytes, t, verify(dest));
+
+    // ---------------------- read(2), one request at a time ------------------------
+    fresh();
+    t = time_s([&]
+               {
+        int fd = open(path.c_str(), O_RDONLY);
+        std::size_t done = 0;
+        ssize_t got;
+        while (done < bytes && (got = read(fd, dest.data() + done, std::min<std::size_t>(1 << 20, bytes - done))) > 0)
+        {
+            done += static_cast<std::size_t>(got);
+        }
+        close(fd); });
+    report("read(2)    ", bytes, t, verify(dest));
+
+    // ---------------------- mmap + copy ------------------------
+    fresh();
+    t = time_s([&]
+               {
+        int fd = open(path.c_str(), O_RDONLY);
+        void *mem = mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+        if (mem != MAP_FAILED)
+        {
+            std::memcpy(dest.data(), mem, bytes);
+            munmap(mem, bytes);
+        }
+        close(fd); });
+    report("mmap+memcpy", bytes, t, verify(dest));
+
+    // ---------------------- async reader ------------------------
+    ReadOptions opts;
+    ReadResult uring = read_file(path, fresh(), opts);
+    report(std::string(uring.backend) + " (qd " + std::to_string(opts.queue_depth) + ")",
+           uring.bytes, uring.seconds, uring.ok && verify(dest));
+
+    opts.direct = true;
+    ReadResult direct = read_file(path, fresh(), opts);
+    report(std::string(direct.backend) + (direct.direct ? " + O_DIRECT" : " (O_DIRECT unsupported here, buffered)"),
+           direct.bytes, direct.seconds, direct.ok && verify(dest));
+
+    opts.direct = false;
+    opts.force_fallback = true;
+    ReadResult pool = read_file(path, fresh(), opts);
+    report(pool.backend, pool.bytes, pool.seconds, pool.ok && verify(dest));
+
+    opts.queue_depth = 0;
+    try
+    {
+        read_file(path, dest, opts);
+    }
+    catch (const std::invalid_argument &e)
+    {
+        std::cout << "  rejected: " << e.what() << '\n';
+    }
+
+    // ---------------------- USE THE DATA AS AN ARRAY ------------------------
+    std::span<const int> ints(reinterpret_cast<const int *>(dest.data()), bytes / sizeof(int));
+    std::cout << "\nLast int = " << ints.back() << " (expected " << ints.size() - 1 << ")\n";
+
+    std::remove(path.c_str());
+    return 0;
+}
+
+/*
+----------------------------------------------------------------------
+KEY TAKEAWAYS:
+----------------------------------------------------------------------
+1. Throughput on fast SSDs comes from QUEUE DEPTH: many requests in flight.
+   A single read() loop has depth 1.
+
+2. io_uring: write requests (SQEs) into a shared ring, one io_uring_enter
+   syscall submits them all, completions (CQEs) come back in another ring.
+   The ring indices are shared with the kernel, so we use acquire/release
+   atomics (std::atomic_ref) on them.
+
+3. Short reads happen; the reader re-queues the remainder of a block.
+   Every path is checked value by value: fast but wrong is not a result.
+
+4. O_DIRECT skips the page cache but needs 4096-byte aligned buffers,
+   offsets and lengths → std::aligned_alloc + unique_ptr with a free()
+   deleter (compare the custom munmap deleter in 34numa_huge_pages.cpp).
+
+5. No io_uring? A handful of threads doing blocking pread() also keeps
+   several requests in flight and is a decent fallback.
+
+- How to Run:
+    g++ 42io_uring_reader.cpp -o uring --std=c++20 -O2 -pthread
+    ./uring                          # 256 MB file in the current directory
+    ./uring /mnt/nvme/test.bin 4096  # 4 GB file on an NVMe drive
+----------------------------------------------------------------------
+*/
@@ -0,0 +1,449 @@
+#include <iostream>    // For std::cout
+#include <fstream>     // For the text-dump baseline
+#include <vector>      // For the data we save
+#include <span>        // For zero-copy column views (see 24std_span.cpp)
+#include <string>      // For file names
+#include <string_view> // For column names
+#include <cstring>     // For std::memcpy, std::strncpy, strnlen, std::memchr
+#include <cstdint>     // For fixed-width header fields (see 06integers.cpp)
+#include <type_traits> // For std::is_trivially_copyable_v
+#include <optional>    // For lookups that may fail
+#include <chrono>      // For timing
+#include <cstdio>      // For std::remove
+#include <utility>     // For std::exchange
+#include <climits>     // For IOV_MAX
+
+#include <fcntl.h>    // open
+#include <unistd.h>   // close
+#include <sys/mman.h> // mmap, munmap
+#include <sys/stat.h> // fstat
+#include <sys/uio.h>  // writev (vectored write)
+
+/*
+----------------------------------------------------------------------
+TOPIC: A BINARY COLUMN FILE WITH ZERO-COPY READS
+----------------------------------------------------------------------
+Points, MyArray and vectors so far only live in memory and get printed
+as text. Text is easy to read but slow to load: every number has to be
+parsed character by character.
+
+Binary idea: write the bytes of the array EXACTLY as they sit in memory.
+Loading is then just mmap: the file's bytes become a std::span<const T>
+with no parsing and no copies.
+
+File layout (all offsets from the start of the file):
+
+    +--------------------+  offset 0
+    | FileHeader         |  magic "CPPL", version, column count
+    +--------------------+
+    | ColumnInfo × N     |  name, type, element size, count, data offset
+    +--------------------+
+    | padding            |  so the first column starts on a 64-byte boundary
+    | column 0 data      |
+    | padding            |
+    | column 1 data      |
+    | ...                |
+    +--------------------+
+
+- Version: lets future code detect files written by an older layout.
+- Type + element size: the reader refuses to view a float column as Points.
+- Alignment: mmap gives page-aligned memory, so a 64-byte aligned offset
+  inside the file is 64-byte aligned in memory too → safe to read as T.
+
+The whole file is written with ONE writev() call: an array of
+(pointer, length) pairs for header, column table, padding and data.
+----------------------------------------------------------------------
+*/
+
+struct Point
+{
+    int x = 0;
+    int y = 0;
+};
+
+// ------------------------ TYPE TAGS -----------------------------
+
+enum class ColumnType : uint32_t
+{
+    Int32 = 1,
+    Int64 = 2,
+    Float64 = 3,
+    Point = 4, // struct Point { int x, y; }
+};
+
+// Map C++ types to their tag at compile time (template specialization, like 14.cpp)
+template <typename T>
+struct ColumnTypeOf;
+template <>
+struct ColumnTypeOf<int32_t>
+{
+    static constexpr ColumnType value = ColumnType::Int32;
+};
+template <>
+struct ColumnTypeOf<int64_t>
+{
+    static constexpr ColumnType value = ColumnType::Int64;
+};
+template <>
+struct ColumnTypeOf<double>
+{
+    static constexpr ColumnType value = ColumnType::Float64;
+};
+template <>
+struct ColumnTypeOf<Point>
+{
+    static constexpr ColumnType value = ColumnType::Point;
+};
+
+// ------------------------ ON-DISK STRUCTS -----------------------------
+
+constexpr uint32_t kMagic = 0x4C505043; // "CPPL" in little-endian
+constexpr uint16_t kVersion = 1;
+constexpr std::size_t kDataAlign = 64;
+
+struct FileHeader
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t column_count;
+    uint64_t file_size;
+};
+
+struct ColumnInfo
+{
+    char name[24];      // zero padded, always NUL terminated
+    ColumnType type;    // what the bytes mean
+    uint32_t elem_size; // sizeof(T) when written
+    uint64_t count;     // number of elements
+    uint64_t offset;    // byte offset of the data in the file
+};
+
+// Fixed-width fields only, so the layout is the same on every 64-bit compiler
+static_assert(sizeof(FileHeader) == 16);
+static_assert(sizeof(ColumnInfo) == 48);
+
+// ------------------------ WRITER -----------------------------
+
+class ColumnWriter
+{
+public:
+    template <typename T>
+    void add(std::string_view name, std::span<const T> data)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "only raw-byte types can be written as-is");
+        ColumnInfo info{};
+        std::strncpy(info.name, std::string(name).c_str(), sizeof(info.name) - 1);
+        info.type = ColumnTypeOf<T>::value;
+        info.elem_size = sizeof(T);
+        info.count = data.size();
+        columns_.push_back(info);
+        payloads_.push_back({data.data(), data.size_bytes()});
+    }
+
+    bool write(const std::string &path)
+    {
+        // 1. Decide where everything goes
+        uint64_t offset = sizeof(FileHeader) + columns_.size() * sizeof(ColumnInfo);
+        for (std::size_t i = 0; i < columns_.size(); i++)
+        {
+            offset = align_up(offset);
+            columns_[i].offset = offset;
+            offset += payloads_[i].bytes;
+        }
+        FileHeader header{kMagic, kVersion, static_cast<uint16_t>(columns_.size()), offset};
+
+        // 2. One iovec per piece: header, column table, then (padding, data) per column
+        static const char zeros[kDataAlign] = {};
+        std::vector<iovec> pieces;
+        pieces.push_back({&header, sizeof(header)});
+        pieces.push_back({columns_.data(), columns_.size() * sizeof(ColumnInfo)});
+        uint64_t pos = sizeof(FileHeader) + columns_.size() * sizeof(ColumnInfo);
+        for (std::size_t i = 0; i < columns_.size(); i++)
+        {
+            if (columns_[i].offset > pos)
+            {
+                pieces.push_back({const_cast<char *>(zeros), columns_[i].offset - pos});
+            }
+            pieces.push_back({const_cast<void *>(payloads_[i].data), payloads_[i].bytes});
+            pos = columns_[i].offset + payloads_[i].bytes;
+        }
+
+        // 3. A single vectored write (looping only if the kernel writes less)
+        int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0)
+        {
+            return false;
+        }
+        bool ok = write_all(fd, pieces);
+        close(fd);
+        return ok;
+    }
+
+private:
+    struct Payload
+    {
+        const void *data;
+        std::size_t bytes;
+    };
+
+    static uint64_t align_up(uint64_t n) { return (n + kDataAlign - 1) / kDataAlign * kDataAlign; }
+
+    static bool write_all(int fd, std::vector<iovec> &pieces)
+    {
+        std::size_t first = 0;
+        while (first < pieces.size())
+        {
+            int n = static_cast<int>(std::min<std::size_t>(pieces.size() - first, IOV_MAX));
+            ssize_t written = writev(fd, &pieces[first], n);
+            if (written < 0)
+            {
+                return false;
+            }
+            // Skip fully written pieces, trim a partially written one
+            auto left = static_cast<std::size_t>(written);
+            while (first < pieces.size() && left >= pieces[first].iov_len)
+            {
+                left -= pieces[first].iov_len;
+                first++;
+            }
+            if (left > 0)
+            {
+                pieces[first].iov_base = static_cast<char *>(pieces[first].iov_base) + left;
+                pieces[first].iov_len -= left;
+            }
+        }
+        return true;
+    }
+
+    std::vector<ColumnInfo> columns_;
+    std::vector<Payload> payloads_;
+};
+
+// ------------------------ READER (mmap, zero copy) -----------------------------
+
+class ColumnFile
+{
+public:
+    explicit ColumnFile(const std::string &path)
+    {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            return;
+        }
+        struct stat st;
+        if (fstat(fd, &st) == 0 && static_cast<std::size_t>(st.st_size) >= sizeof(FileHeader))
+        {
+            size_ = static_cast<std::size_t>(st.st_size);
+            void *mem = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+            base_ = mem == MAP_FAILED ? nullptr : static_cast<const std::byte *>(mem);
+        }
+        close(fd); // the mapping stays valid after close
+        if (base_ != nullptr && !valid())
+        {
+            munmap(const_cast<std::byte *>(base_), size_);
+            base_ = nullptr;
+        }
+    }
+
+    ColumnFile(const ColumnFile &) = delete;
+    ColumnFile(ColumnFile &&other) noexcept
+        : base_(std::exchange(other.base_, nullptr)), size_(other.size_) {}
+
+    ~ColumnFile()
+    {
+        if (base_ != nullptr)
+        {
+            munmap(const_cast<std::byte *>(base_), size_);
+        }
+    }
+
+    bool is_open() const { return base_ != nullptr; }
+
+    // View a column as a span — no copy, no parsing. Empty if the name or type doesn't match.
+    template <typename T>
+    std::optional<std::span<const T>> column(std::string_view name) const
+    {
+        for (const ColumnInfo &info : columns())
+        {
+            // valid() checked the terminator; still never strlen bytes from a file
+            if (name == std::string_view(info.name, strnlen(info.name, sizeof info.name)))
+            {
+                if (info.type != ColumnTypeOf<T>::value || info.elem_size != sizeof(T))
+                {
+                    return std::nullopt; // wrong type: refuse instead of reinterpreting
+                }
+                return std::span<const T>(reinterpret_cast<const T *>(base_ + info.offset), info.count);
+            }
+        }
+        return std::nullopt;
+    }
+
+private:
+    const FileHeader &header() const { return *reinterpret_cast<const FileHeader *>(base_); }
+
+    std::span<const ColumnInfo> columns() const
+    {
+        return {reinterpret_cast<const ColumnInfo *>(base_ + sizeof(FileHeader)), header().column_count};
+    }
+
+    // Never trust a file: check every offset before handing out spans
+    bool valid() const
+    {
+        const FileHeader &h = header();
+        if (h.magic != kMagic || h.version != kVersion || h.file_size != size_)
+        {
+            return false;
+        }
+        if (sizeof(FileHeader) + h.column_count * sizeof(ColumnInfo) > size_)
+        {
+            return false;
+        }
+        for (const ColumnInfo &info : columns())
+        {
+            if (std::memchr(info.name, '\0', sizeof info.name) == nullptr)
+            {
+                return false; // no terminator: a crafted name would make lookups over-read
+            }
+            if (info.offset % kDataAlign != 0 || info.elem_size == 0 ||
+                info.count > (size_ - std::min<uint64_t>(info.offset, size_)) / info.elem_size)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    const std::byte *base_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+// ------------------------ BENCHMARK HELPERS -----------------------------
+
+template <typename F>
+double time_ms(F &&f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+int main()
+{
+    // ---------------------- DATA ------------------------
+    constexpr std::size_t kN = 5'000'000;
+    std::vector<Point> points(kN);
+    std::vector<double> weights(kN);
+    std::vector<int32_t> ids(kN);
+    for (std::size_t i = 0; i < kN; i++)
+    {
+        points[i] = {static_cast<int>(i), static_cast<int>(i * 2)};
+        weights[i] = i * 0.5;
+        ids[i] = static_cast<int32_t>(i);
+    }
+
+    const std::string bin_path = "points.cppl";
+    const std::string txt_path = "points.txt";
+
+    // ---------------------- WRITE BINARY ------------------------
+    ColumnWriter writer;
+    writer.add<Point>("points", points);
+    writer.add<double>("weights", weights);
+    writer.add<int32_t>("ids", ids);
+    double write_ms = time_ms([&]
+                              { writer.write(bin_path); });
+
+    // ---------------------- WRITE TEXT (baseline) ------------------------
+    {
+        std::ofstream txt(txt_path);
+        for (const auto &p : points)
+        {
+            txt << p.x << ' ' << p.y << '\n';
+        }
+    }
+
+    // ---------------------- LOAD: text parse vs mmap ------------------------
+    std::vector<Point> parsed;
+    double text_ms = time_ms([&]
+                             {
+        std::ifstream txt(txt_path);
+        Point p;
+        while (txt >> p.x >> p.y)
+        {
+            parsed.push_back(p);
+        } });
+
+    long long checksum = 0;
+    double mmap_ms = time_ms([&]
+                             {
+        ColumnFile file(bin_path);
+        auto pts = file.column<Point>("points");
+        if (pts)
+        {
+            // Touch every element so the comparison is fair (pages get faulted in)
+            for (const auto &p : *pts)
+            {
+                checksum += p.x + p.y;
+            }
+        } });
+
+    // ---------------------- ROUND TRIP CHECK ------------------------
+    ColumnFile file(bin_path);
+    auto pts = file.column<Point>("points");
+    auto w = file.column<double>("weights");
+    auto wrong = file.column<double>("points"); // type mismatch → nullopt
+
+    bool same = pts && pts->size() == points.size() &&
+                std::memcmp(pts->data(), points.data(), points.size() * sizeof(Point)) == 0;
+
+    std::cout << "Binary write (1 writev):  " << write_ms << " ms\n";
+    std::cout << "Load text (parse):        " << text_ms << " ms\n";
+    std::cout << "Load binary (mmap+touch): " << mmap_ms << " ms  → "
+              << text_ms / mmap_ms << "x faster\n";
+    std::cout << "Points round-trip equal:  " << same << '\n';
+    std::cout << "weights[10] = " << (*w)[10] << ", wrong type rejected: " << !wrong.has_value() << '\n';
+    std::cout << "checksum " << checksum << ", parsed " << parsed.size() << " text points\n";
+
+    // ---------------------- CRAFTED FILE: name without NUL ------------------------
+    const std::string bad_path = "bad.cppl";
+    {
+        ColumnWriter small;
+        small.add<int32_t>("ids", std::span<const int32_t>(ids.data(), 16));
+        small.write(bad_path);
+        std::fstream patch(bad_path, std::ios::in | std::ios::out | std::ios::binary);
+        patch.seekp(sizeof(FileHeader)); // first ColumnInfo::name
+        patch.write("AAAAAAAAAAAAAAAAAAAAAAAA", sizeof(ColumnInfo::name));
+    }
+    std::cout << "Unterminated column name rejected: " << !ColumnFile(bad_path).is_open() << '\n';
+    std::remove(bad_path.c_str());
+
+    std::remove(bin_path.c_str());
+    std::remove(txt_path.c_str());
+    return 0;
+}
+
+/*
+----------------------------------------------------------------------
+KEY TAKEAWAYS:
+----------------------------------------------------------------------
+1. For trivially copyable types, the in-memory bytes ARE a valid file
+   format. Writing is a memcpy to disk, reading is a memory mapping.
+
+2. A header with magic + version + typed column table makes the raw bytes
+   self-describing and lets the reader reject wrong or corrupted files.
+
+3. Aligning each column to 64 bytes keeps `reinterpret_cast<const T*>`
+   on the mapped memory properly aligned.
+
+4. writev() sends many (pointer, length) buffers in one system call, so we
+   never build one big contiguous copy of the file in memory.
+
+5. Caveats: the file uses the machine's endianness and struct layout.
+   Fixed-width types and static_assert(sizeof(...)) guard the layout;
+   a portable format would also record endianness.
+
+- How to Run:
+    g++ 43binary_format.cpp -o binfmt --std=c++20 -O2
+----------------------------------------------------------------------
+*/
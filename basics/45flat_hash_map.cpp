@@ -0,0 +1,493 @@
+#include <iostream>      // For std::cout
+#include <vector>        // For benchmark data
+#include <span>          // For bulk insert / lookup (see 24std_span.cpp)
+#include <memory>        // For std::unique_ptr storage
+#include <unordered_map> // The baseline we compare against
+#include <utility>       // For std::pair, std::move
+#include <functional>    // For std::equal_to
+#include <optional>      // For find() results
+#include <random>        // For test keys
+#include <chrono>        // For timing
+#include <cstdint>       // For uint8_t, uint64_t
+#include <cstring>       // For std::memset
+#include <bit>           // For std::countr_zero
+#include <string>        // For std::stoul
+#include <algorithm>     // For std::shuffle, std::max
+#include <stdexcept>     // For std::invalid_argument
+
+#if defined(__SSE2__)
+#include <emmintrin.h> // SSE2: compare 16 control bytes at once
+#endif
+
+/*
+----------------------------------------------------------------------
+TOPIC: A FLAT OPEN-ADDRESSING HASH MAP (SwissTable style)
+----------------------------------------------------------------------
+std::unordered_map stores every element in its own heap node, linked from
+a bucket array. A lookup = hash → bucket → pointer → node → maybe another
+pointer... Each arrow is a potential cache miss.
+
+A "flat" (open-addressing) map stores keys and values INLINE in one big
+array. A collision simply tries the next position. No nodes, no pointers.
+
+The SwissTable trick (used by Abseil / Rust's HashMap):
+- Next to the slots keep a CONTROL BYTE per slot:
+      0x80 (-128)  = empty
+      0xFE (-2)    = deleted ("tombstone")
+      0x00..0x7F   = full, holding 7 bits of the key's hash ("h2")
+- Slots are grouped in 16s. One SSE2 instruction compares all 16 control
+  bytes of a group with h2 at once and returns a 16-bit match mask.
+- Only slots whose 7-bit fingerprint matches are compared for real, so
+  nearly every lookup touches ONE group and ONE slot.
+
+    hash(key) = [ h1 : 57 bits | h2 : 7 bits ]
+    h1 picks the starting group, h2 goes into the control byte.
+----------------------------------------------------------------------
+*/
+
+// ------------------------ HASHING -----------------------------
+
+// Integer keys need mixing: identity hashes would put 0,1,2,... in one group
+struct IntHash
+{
+    using is_transparent = void; // allows find(int) on a map keyed by int64_t
+
+    template <typename T>
+    uint64_t operator()(T key) const
+    {
+        uint64_t x = static_cast<uint64_t>(key);
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccdULL;
+        x ^= x >> 33;
+        x *= 0xc4ceb9fe1a85ec53ULL;
+        x ^= x >> 33;
+        return x;
+    }
+};
+
+// ------------------------ GROUP MATCHING -----------------------------
+
+constexpr std::size_t kGroup = 16;
+constexpr int8_t kEmpty = -128; // 0b1000'0000
+constexpr int8_t kDeleted = -2; // 0b1111'1110
+
+// Bit i set ⇔ ctrl[i] == value
+inline uint32_t match_byte(const int8_t *ctrl, int8_t value)
+{
+#if defined(__SSE2__)
+    __m128i group = _mm_loadu_si128(reinterpret_cast<const __m128i *>(ctrl));
+    return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(value))));
+#else
+    uint32_t mask = 0;
+    for (std::size_t i = 0; i < kGroup; i++)
+        mask |= static_cast<uint32_t>(ctrl[i] == value) << i;
+    return mask;
+#endif
+}
+
+// Bit i set ⇔ ctrl[i] is empty or deleted (the sign bit is set only for those)
+inline uint32_t match_empty_or_deleted(const int8_t *ctrl)
+{
+#if defined(__SSE2__)
+    __m128i group = _mm_loadu_si128(reinterpret_cast<const __m128i *>(ctrl));
+    return static_cast<uint32_t>(_mm_movemask_epi8(group));
+#else
+    uint32_t mask = 0;
+    for (std::size_t i = 0; i < kGroup; i++)
+        mask |= static_cast<uint32_t>(ctrl[i] < 0) << i;
+    return mask;
+#endif
+}
+
+// ------------------------ THE MAP -----------------------------
+
+template <typename K, typename V, typename Hash = IntHash, typename Eq = std::equal_to<>>
+class FlatHashMap
+{
+public:
+    struct Slot
+    {
+        K key;
+        V value;
+    };
+
+    FlatHashMap() = default;
+
+    std::size_t size() const { return size_; }
+    std::size_t capacity() const { return capacity_; }
+
+    // Make room for n elements without rehashing
+    void reserve(std::size_t n)
+    {
+        std::size_t needed = n * 8 / 7 + 1; // keep load factor ≤ 7/8
+        if (needed > capacity_)
+        {
+            rehash(needed);
+        }
+    }
+
+    // Inserts or overwrites. Returns true if the key was new.
+    bool insert(const K &key, V value)
+    {
+        if ((size_ + tombstones_ + 1) * 8 > capacity_ * 7)
+        {
+            // Mostly tombstones → clean up in place; otherwise size the table
+            // from the live count, so insert/erase churn never grows it
+            if (tombstones_ >= size_)
+            {
+                rehash(capacity_);
+            }
+            else
+            {
+                rehash((size_ + 1) * 2); // next power of two ≥ 2x live → load ≤ ~1/2 after
+            }
+        }
+        uint64_t h = hash_(key);
+        if (Slot *slot = find_slot(key, h))
+        {
+            slot->value = std::move(value);
+            return false;
+        }
+        std::size_t index = find_insert_position(h);
+        if (ctrl_[index] == kDeleted)
+        {
+            tombstones_--;
+        }
+        ctrl_[index] = h2(h);
+        slots_[index] = Slot{key, std::move(value)};
+        size_++;
+        return true;
+    }
+
+    // Heterogeneous lookup: any Q that Hash and Eq accept (e.g. int for an int64_t map)
+    template <typename Q>
+    V *find(const Q &key)
+    {
+        Slot *slot = find_slot(key, hash_(key));
+        return slot ? &slot->value : nullptr;
+    }
+
+    template <typename Q>
+    const V *find(const Q &key) const
+    {
+        return const_cast<FlatHashMap *>(this)->find(key);
+    }
+
+    template <typename Q>
+    bool erase(const Q &key)
+    {
+        Slot *slot = find_slot(key, hash_(key));
+        if (slot == nullptr)
+        {
+            return false;
+        }
+        std::size_t index = static_cast<std::size_t>(slot - slots_.get());
+        ctrl_[index] = kDeleted; // tombstone keeps probe chains intact
+        slot->value = V{};
+        size_--;
+        tombstones_++;
+        return true;
+    }
+
+    // ---------------------- BULK API ------------------------
+
+    void insert_bulk(std::span<const K> keys, std::span<const V> values)
+    {
+        if (values.size() != keys.size())
+        {
+            throw std::invalid_argument("insert_bulk: keys and values differ in size");
+        }
+        reserve(size_ + keys.size());
+        for (std::size_t i = 0; i < keys.size(); i++)
+        {
+            insert(keys[i], values[i]);
+        }
+    }
+
+    /*
+    Looks up many keys. Hashes are computed a few keys ahead and their
+    control groups prefetched, so several cache misses overlap instead of
+    happening one after another. out[i] = value, or `missing`.
+    */
+    std::size_t find_bulk(std::span<const K> keys, std::span<V> out, V missing = V{}) const
+    {
+        if (out.size() < keys.size())
+        {
+            throw std::invalid_argument("find_bulk: out shorter than keys");
+        }
+        constexpr std::size_t kAhead = 8;
+        std::size_t found = 0;
+        for (std::size_t i = 0; i < keys.size(); i++)
+        {
+            if (i + kAhead < keys.size() && capacity_ > 0)
+            {
+                uint64_t ahead = hash_(keys[i + kAhead]);
+                std::size_t g = group_start(ahead);
+                __builtin_prefetch(&ctrl_[g]);
+                __builtin_prefetch(&slots_[g]);
+            }
+            const V *v = find(keys[i]);
+            out[i] = v ? *v : missing;
+            found += v != nullptr;
+        }
+        return found;
+    }
+
+    // Visit every element (order is unspecified)
+    template <typename Visit>
+    void for_each(Visit &&visit) const
+    {
+        for (std::size_t i = 0; i < capacity_; i++)
+        {
+            if (ctrl_[i] >= 0)
+            {
+                visit(slots_[i].key, slots_[i].value);
+            }
+        }
+    }
+
+private:
+    static int8_t h2(uint64_t h) { return static_cast<int8_t>(h & 0x7F); }
+    std::size_t group_start(uint64_t h) const { return ((h >> 7) & (capacity_ / kGroup - 1)) * kGroup; }
+
+    // Probe group after group (triangular steps visit every group exactly once)
+    template <typename Q>
+    Slot *find_slot(const Q &key, uint64_t h) const
+    {
+        if (capacity_ == 0)
+        {
+            return nullptr;
+        }
+        std::size_t groups = capacity_ / kGroup;
+        std::size_t g = (h >> 7) & (groups - 1);
+        for (std::size_t step = 1; step <= groups; step++)
+        {
+            const int8_t *ctrl = &ctrl_[g * kGroup];
+            uint32_t matches = match_byte(ctrl, h2(h));
+            while (matches != 0)
+            {
+                std::size_t i = g * kGroup + std::countr_zero(matches);
+                if (eq_(slots_[i].key, key))
+                {
+                    return &slots_[i];
+                }
+                matches &= matches - 1; // clear lowest set bit
+            }
+            if (match_byte(ctrl, kEmpty) != 0)
+            {
+                return nullptr; // an empty slot ends the probe chain
+            }
+            g = (g + step) & (groups - 1);
+        }
+        return nullptr;
+    }
+
+    std::size_t find_insert_position(uint64_t h) const
+    {
+        std::size_t groups = capacity_ / kGroup;
+        std::size_t g = (h >> 7) & (groups - 1);
+        for (std::size_t step = 1;; step++)
+        {
+            uint32_t free = match_empty_or_deleted(&ctrl_[g * kGroup]);
+            if (free != 0)
+            {
+                return g * kGroup + std::countr_zero(free);
+            }
+            g = (g + step) & (groups - 1);
+        }
+    }
+
+    void rehash(std::size_t min_capacity)
+    {
+        std::size_t cap = kGroup;
+        while (cap < min_capacity)
+        {
+            cap <<= 1; // power of two number of groups → masks instead of %
+        }
+
+        auto old_ctrl = std::move(ctrl_);
+        auto old_slots = std::move(slots_);
+        std::size_t old_cap = capacity_;
+
+        ctrl_ = std::make_unique<int8_t[]>(cap);
+        std::memset(ctrl_.get(), kEmpty, cap);
+        slots_ = std::make_unique<Slot[]>(cap);
+        capacity_ = cap;
+        size_ = 0;
+        tombstones_ = 0;
+
+        for (std::size_t i = 0; i < old_cap; i++)
+        {
+            if (old_ctrl[i] >= 0)
+            {
+                uint64_t h = hash_(old_slots[i].key);
+                std::size_t index = find_insert_position(h);
+                ctrl_[index] = h2(h);
+                slots_[index] = std::move(old_slots[i]);
+                size_++;
+            }
+        }
+    }
+
+    std::unique_ptr<int8_t[]> ctrl_;
+    std::unique_ptr<Slot[]> slots_;
+    std::size_t capacity_ = 0;
+    std::size_t size_ = 0;
+    std::size_t tombstones_ = 0;
+    [[no_unique_address]] Hash hash_;
+    [[no_unique_address]] Eq eq_;
+};
+
+// ------------------------ BENCHMARK -----------------------------
+
+struct Point
+{
+    int x = 0;
+    int y = 0;
+};
+
+template <typename F>
+double time_ns_per(std::size_t n, F &&f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / n;
+}
+
+void bench(std::size_t n)
+{
+    std::mt19937_64 rng(n);
+    std::vector<int64_t> keys(n);
+    std::vector<Point> values(n);
+    for (std::size_t i = 0; i < n; i++)
+    {
+        keys[i] = static_cast<int64_t>(rng());
+        values[i] = {static_cast<int>(i), static_cast<int>(i)};
+    }
+    // Lookup order differs from insertion order
+    std::vector<int64_t> queries(keys);
+    std::shuffle(queries.begin(), queries.end(), rng);
+
+    FlatHashMap<int64_t, Point> flat;
+    std::unordered_map<int64_t, Point> stdmap;
+
+    double flat_insert = time_ns_per(n, [&]
+                                     { flat.insert_bulk(keys, values); });
+    double std_insert = time_ns_per(n, [&]
+                                    {
+        stdmap.reserve(n);
+        for (std::size_t i = 0; i < n; i++)
+            stdmap[keys[i]] = values[i]; });
+
+    long long sum_flat = 0, sum_std = 0;
+    double flat_find = time_ns_per(n, [&]
+                                   {
+        for (auto k : queries)
+            sum_flat += flat.find(k)->x; });
+    std::vector<Point> out(n);
+    double flat_bulk = time_ns_per(n, [&]
+                                   { flat.find_bulk(queries, out); });
+    double std_find = time_ns_per(n, [&]
+                                  {
+        for (auto k : queries)
+            sum_std += stdmap.find(k)->second.x; });
+
+    std::cout << n << " entries\n"
+              << "  insert   flat " << flat_insert << " ns, unordered_map " << std_insert << " ns\n"
+              << "  find     flat " << flat_find << " ns, bulk " << flat_bulk << " ns, unordered_map "
+              << std_find << " ns  (sums equal " << (sum_flat == sum_std) << ")\n";
+}
+
+int main(int argc, char *argv[])
+{
+    // ---------------------- BASIC USAGE ------------------------
+    FlatHashMap<int64_t, Point> map;
+    map.insert(7, {1, 2});
+    map.insert(42, {3, 4});
+    map.insert(7, {5, 6}); // overwrite
+
+    int small_key = 42; // an int, not an int64_t → heterogeneous lookup
+    std::cout << "find(42).x = " << map.find(small_key)->x << '\n';
+    std::cout << "find(7).y  = " << map.find(int64_t{7})->y << '\n';
+    map.erase(int64_t{7});
+    std::cout << "after erase, find(7) = " << (map.find(int64_t{7}) ? "found" : "missing")
+              << ", size = " << map.size() << '\n';
+    std::vector<int64_t> three_keys{1, 2, 3};
+    std::vector<Point> two_values(2);
+    try
+    {
+        map.insert_bulk(three_keys, two_values);
+    }
+    catch (const std::invalid_argument &e)
+    {
+        std::cout << "rejected: " << e.what() << '\n';
+    }
+    try
+    {
+        map.find_bulk(three_keys, two_values);
+    }
+    catch (const std::invalid_argument &e)
+    {
+        std::cout << "rejected: " << e.what() << '\n';
+    }
+
+    // Churn: constant live size, many insert/erase pairs → capacity must stay flat
+    FlatHashMap<int64_t, Point> churn;
+    for (int64_t k = 0; k < 1000; k++)
+    {
+        churn.insert(k, {0, 0});
+    }
+    std::size_t cap_before = churn.capacity();
+    for (int64_t k = 1000; k < 1'000'000; k++)
+    {
+        churn.erase(k - 1000);
+        churn.insert(k, {0, 0});
+    }
+    std::cout << "churn (1M insert/erase at size 1000): capacity " << cap_before << " → " << churn.capacity()
+              << (churn.capacity() == cap_before ? " (flat)" : " (GREW)") << "\n\n";
+
+#if defined(__SSE2__)
+    std::cout << "Group probing: SSE2 (16 control bytes per compare)\n\n";
+#else
+    std::cout << "Group probing: scalar fallback\n\n";
+#endif
+
+    // ---------------------- BENCHMARK ------------------------
+    std::size_t max_n = argc > 1 ? std::stoul(argv[1]) : 10'000'000; // pass 100000000 for 100M
+    for (std::size_t n = 1'000; n <= max_n; n *= 10)
+    {
+        bench(n);
+    }
+    return 0;
+}
+
+/*
+----------------------------------------------------------------------
+KEY TAKEAWAYS:
+----------------------------------------------------------------------
+1. Open addressing keeps keys and values in one flat array → a lookup is
+   usually one cache miss for the control group and one for the slot,
+   versus several pointer hops in std::unordered_map.
+
+2. Control bytes with a 7-bit hash fingerprint let ONE SSE2 compare
+   (_mm_cmpeq_epi8 + _mm_movemask_epi8) test 16 slots at once; only real
+   fingerprint matches compare keys.
+
+3. Deletion leaves a tombstone so later keys in the same probe chain are
+   still found; rehashing cleans tombstones up. When tombstones are most
+   of the load, rehash at the SAME capacity: growth is sized from live
+   entries only, so insert/erase churn doesn't grow the table forever.
+
+4. `using is_transparent = void` on the hasher plus a templated find(Q)
+   enables heterogeneous lookup without converting the key first.
+
+5. Bulk lookup prefetches the control group of a key 8 positions ahead,
+   so cache misses for different keys overlap.
+
+- How to Run:
+    g++ 45flat_hash_map.cpp -o flatmap --std=c++20 -O2
+    ./flatmap             # 1K .. 10M entries
+    ./flatmap 100000000   # up to 100M (needs several GB of RAM)
+----------------------------------------------------------------------
+*/
@@ -0,0 +1,683 @@
+#include <iostream>  // For std::cout
+#include <vector>    // For bitset words and containers
+#include <span>      // For columns (see 24std_span.cpp)
+#include <cstdint>   // For uint64_t / uint16_t (see 06integers.cpp)
+#include <bit>       // For std::popcount, std::countr_zero (C++20)
+#include <algorithm> // For std::lower_bound, std::set_intersection
+#include <iterator>  // For std::back_inserter
+#include <random>    // For test data
+#include <chrono>    // For timing
+#include <string>    // For std::stoul
+#include <stdexcept> // For std::invalid_argument
+
+#if defined(__AVX2__)
+#include <immintrin.h> // AVX2: 256-bit AND/OR and compare-to-mask
+#endif
+
+/*
+----------------------------------------------------------------------
+TOPIC: BITSETS AND BITMAP INDEXES (filtering with bit-parallel ops)
+----------------------------------------------------------------------
+08conditions.cpp decides with if/else one value at a time. Filtering a
+column that way:
+
+    for (x : column) if (x > 100 && x < 200) count++;
+
+costs a branch per element. With random data the CPU mispredicts about
+half of them (~15 cycles each).
+
+Bitmap approach:
+1. Evaluate each predicate ONCE per row into a bit: 1 = row matches.
+   64 rows fit in one uint64_t, and no branch is needed:
+       word |= uint64_t(x > 100) << j;
+   With AVX2, 8 ints are compared at once and _mm256_movemask_ps turns
+   the 8 results into 8 bits.
+2. Combine predicates with AND / OR / ANDNOT on whole words:
+   one instruction handles 64 rows (256 with AVX2).
+3. Count matches with popcount, or walk the set bits to get row ids.
+
+Two structures:
+- DenseBitset: one bit per row, simple and fastest when many bits are set.
+- RoaringBitmap: splits row ids into chunks of 65536. Each chunk stores
+  either a sorted array of 16-bit values (when sparse, ≤ 4096 entries) or
+  a 65536-bit bitmap (when dense). Memory follows the data instead of
+  the row count.
+----------------------------------------------------------------------
+*/
+
+// ------------------------ DENSE BITSET -----------------------------
+
+class DenseBitset
+{
+public:
+    DenseBitset() = default;
+    explicit DenseBitset(std::size_t bits) : bits_(bits), words_((bits + 63) / 64, 0) {}
+
+    std::size_t size() const { return bits_; }
+    void set(std::size_t i) { words_[i / 64] |= uint64_t{1} << (i % 64); }
+    bool test(std::size_t i) const { return (words_[i / 64] >> (i % 64)) & 1; }
+
+    std::span<uint64_t> words() { return words_; }
+    std::span<const uint64_t> words() const { return words_; }
+
+    std::size_t count() const
+    {
+        std::size_t total = 0;
+        for (uint64_t w : words_)
+        {
+            total += static_cast<std::size_t>(std::popcount(w)); // one POPCNT instruction with -mpopcnt
+        }
+        return total;
+    }
+
+    // Calls visit(index) for every set bit, lowest first
+    template <typename Visit>
+    void for_each_set(Visit &&visit) const
+    {
+        for (std::size_t w = 0; w < words_.size(); w++)
+        {
+            uint64_t word = words_[w];
+            while (word != 0)
+            {
+                visit(w * 64 + static_cast<std::size_t>(std::countr_zero(word)));
+                word &= word - 1; // clear the lowest set bit
+            }
+        }
+    }
+
+    // ---------------------- SET OPERATIONS (in place) ------------------------
+
+    DenseBitset &operator&=(const DenseBitset &rhs) { return combine(rhs, Op::And); }
+    DenseBitset &operator|=(const DenseBitset &rhs) { return combine(rhs, Op::Or); }
+    DenseBitset &and_not(const DenseBitset &rhs) { return combine(rhs, Op::AndNot); }
+
+private:
+    enum class Op
+    {
+        And,
+        Or,
+        AndNot
+    };
+
+    // Both sides must describe the same rows: a shorter rhs would leave our tail unfiltered
+    DenseBitset &combine(const DenseBitset &rhs, Op op)
+    {
+        if (rhs.bits_ != bits_)
+        {
+            throw std::invalid_argument("DenseBitset: operands cover different row counts");
+        }
+        uint64_t *a = words_.data();
+        const uint64_t *b = rhs.words_.data();
+        std::size_t n = words_.size();
+        std::size_t i = 0;
+#if defined(__AVX2__)
+        for (; i + 4 <= n; i += 4) // 4 words = 256 bits per instruction
+        {
+            __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i));
+            __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + i));
+            __m256i r = op == Op::And  ? _mm256_and_si256(x, y)
+                        : op == Op::Or ? _mm256_or_si256(x, y)
+                                       : _mm256_andnot_si256(y, x); // x & ~y
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(a + i), r);
+        }
+#endif
+        for (; i < n; i++)
+        {
+            a[i] = op == Op::And  ? a[i] & b[i]
+                   : op == Op::Or ? a[i] | b[i]
+                                  : a[i] & ~b[i];
+        }
+        return *this;
+    }
+
+    std::size_t bits_ = 0;
+    std::vector<uint64_t> words_;
+};
+
+// ------------------------ PREDICATE → BITS -----------------------------
+
+// Generic and branchless: the comparison result is used as a number, never as a jump
+template <typename T, typename Pred>
+DenseBitset bits_where(std::span<const T> column, Pred pred)
+{
+    DenseBitset out(column.size());
+    auto words = out.words();
+    for (std::size_t w = 0; w < words.size(); w++)
+    {
+        std::size_t base = w * 64;
+        std::size_t n = std::min<std::size_t>(64, column.size() - base);
+        uint64_t word = 0;
+        for (std::size_t j = 0; j < n; j++)
+        {
+            word |= static_cast<uint64_t>(pred(column[base + j])) << j;
+        }
+        words[w] = word;
+    }
+    return out;
+}
+
+// Specialized x > threshold for int32 columns: 8 compares per AVX2 instruction
+DenseBitset bits_greater(std::span<const int32_t> column, int32_t threshold)
+{
+#if defined(__AVX2__)
+    DenseBitset out(column.size());
+    auto words = out.words();
+    __m256i t = _mm256_set1_epi32(threshold);
+    std::size_t full_words = column.size() / 64;
+    for (std::size_t w = 0; w < full_words; w++)
+    {
+        const int32_t *p = column.data() + w * 64;
+        uint64_t word = 0;
+        for (int k = 0; k < 8; k++) // 8 × 8 ints = 64 bits
+        {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + k * 8));
+            __m256i gt = _mm256_cmpgt_epi32(v, t); // lanes become all-ones or zero
+            auto mask = static_cast<uint64_t>(_mm256_movemask_ps(_mm256_castsi256_ps(gt)));
+            word |= mask << (k * 8);
+        }
+        words[w] = word;
+    }
+    for (std::size_t i = full_words * 64; i < column.size(); i++)
+    {
+        if (column[i] > threshold)
+        {
+            out.set(i);
+        }
+    }
+    return out;
+#else
+    return bits_where(column, [threshold](int32_t x)
+                      { return x > threshold; });
+#endif
+}
+
+// ------------------------ ROARING BITMAP -----------------------------
+
+class RoaringBitmap
+{
+public:
+    void add(uint32_t x)
+    {
+        Container &c = container_for(static_cast<uint16_t>(x >> 16));
+        uint16_t low = static_cast<uint16_t>(x);
+        if (c.is_bitmap)
+        {
+            c.bitmap[low / 64] |= uint64_t{1} << (low % 64);
+            return;
+        }
+        auto it = std::lower_bound(c.array.begin(), c.array.end(), low);
+        if (it == c.array.end() || *it != low)
+        {
+            c.array.insert(it, low);
+            if (c.array.size() > kArrayMax)
+            {
+                to_bitmap(c); // too many values: switch representation
+            }
+        }
+    }
+
+    bool contains(uint32_t x) const
+    {
+        const Container *c = find_container(static_cast<uint16_t>(x >> 16));
+        if (c == nullptr)
+        {
+            return false;
+        }
+        uint16_t low = static_cast<uint16_t>(x);
+        if (c->is_bitmap)
+        {
+            return (c->bitmap[low / 64] >> (low % 64)) & 1;
+        }
+        return std::binary_search(c->array.begin(), c->array.end(), low);
+    }
+
+    std::size_t cardinality() const
+    {
+        std::size_t total = 0;
+        for (const auto &c : containers_)
+        {
+            total += count(c);
+        }
+        return total;
+    }
+
+    std::size_t bytes() const
+    {
+        std::size_t total = 0;
+        for (const auto &c : containers_)
+        {
+            total += sizeof(Container) + (c.is_bitmap ? 8192 : c.array.size() * 2);
+        }
+        return total;
+    }
+
+    // Calls visit(value) for every value in the set, lowest first
+    template <typename Visit>
+    void for_each(Visit &&visit) const
+    {
+        for (const auto &c : containers_)
+        {
+            uint32_t high = uint32_t{c.key} << 16;
+            if (c.is_bitmap)
+            {
+                for (std::size_t w = 0; w < 1024; w++)
+                {
+                    uint64_t word = c.bitmap[w];
+                    while (word != 0)
+                    {
+                        visit(high | static_cast<uint32_t>(w * 64 + static_cast<std::size_t>(std::countr_zero(word))));
+                        word &= word - 1;
+                    }
+                }
+            }
+            else
+            {
+                for (uint16_t v : c.array)
+                {
+                    visit(high | v);
+                }
+            }
+        }
+    }
+
+    // ---------------------- SET OPERATIONS ------------------------
+    // Containers are sorted by key, so each operation is one merge pass:
+    // a chunk present on only one side is skipped (AND) or copied (OR, ANDNOT)
+
+    RoaringBitmap operator&(const RoaringBitmap &rhs) const { return merge(rhs, intersect, false, false); }
+    RoaringBitmap operator|(const RoaringBitmap &rhs) const { return merge(rhs, unite, true, true); }
+    RoaringBitmap and_not(const RoaringBitmap &rhs) const { return merge(rhs, subtract, true, false); }
+
+    static RoaringBitmap from_dense(const DenseBitset &dense)
+    {
+        RoaringBitmap out;
+        dense.for_each_set([&](std::size_t i)
+                           { out.add(static_cast<uint32_t>(i)); });
+        return out;
+    }
+
+private:
+    static constexpr std::size_t kArrayMax = 4096; // 4096 × 2 bytes = 8 KB = size of a bitmap
+
+    struct Container
+    {
+        uint16_t key = 0; // high 16 bits of the values it holds
+        bool is_bitmap = false;
+        std::vector<uint16_t> array;  // sorted, when sparse
+        std::vector<uint64_t> bitmap; // 1024 words, when dense
+    };
+
+    static std::size_t count(const Container &c)
+    {
+        if (!c.is_bitmap)
+        {
+            return c.array.size();
+        }
+        std::size_t total = 0;
+        for (uint64_t w : c.bitmap)
+        {
+            total += static_cast<std::size_t>(std::popcount(w));
+        }
+        return total;
+    }
+
+    static void to_bitmap(Container &c)
+    {
+        c.bitmap.assign(1024, 0);
+        for (uint16_t v : c.array)
+        {
+            c.bitmap[v / 64] |= uint64_t{1} << (v % 64);
+        }
+        c.array.clear();
+        c.array.shrink_to_fit();
+        c.is_bitmap = true;
+    }
+
+    static void to_array(Container &c)
+    {
+        c.array.clear();
+        for (std::size_t w = 0; w < 1024; w++)
+        {
+            for (uint64_t word = c.bitmap[w]; word != 0; word &= word - 1)
+            {
+                c.array.push_back(static_cast<uint16_t>(w * 64 + static_cast<std::size_t>(std::countr_zero(word))));
+            }
+        }
+        c.bitmap.clear();
+        c.bitmap.shrink_to_fit();
+        c.is_bitmap = false;
+    }
+
+    static bool has(const Container &bmp, uint16_t v) { return (bmp.bitmap[v / 64] >> (v % 64)) & 1; }
+
+    static Container intersect(const Container &a, const Container &b)
+    {
+        Container out;
+        out.key = a.key;
+        if (a.is_bitmap && b.is_bitmap)
+        {
+            out.is_bitmap = true;
+            out.bitmap.resize(1024);
+            for (std::size_t w = 0; w < 1024; w++)
+            {
+                out.bitmap[w] = a.bitmap[w] & b.bitmap[w];
+            }
+        }
+        else if (!a.is_bitmap && !b.is_bitmap)
+        {
+            std::set_intersection(a.array.begin(), a.array.end(), b.array.begin(), b.array.end(),
+                                  std::back_inserter(out.array));
+        }
+        else
+        {
+            // array ∩ bitmap: probe each array value in the bitmap
+            const Container &arr = a.is_bitmap ? b : a;
+            const Container &bmp = a.is_bitmap ? a : b;
+            for (uint16_t v : arr.array)
+            {
+                if (has(bmp, v))
+                {
+                    out.array.push_back(v);
+                }
+            }
+        }
+        return out;
+    }
+
+    static Container unite(const Container &a, const Container &b)
+    {
+        if (!a.is_bitmap && !b.is_bitmap)
+        {
+            Container out;
+            out.key = a.key;
+            std::set_union(a.array.begin(), a.array.end(), b.array.begin(), b.array.end(),
+                           std::back_inserter(out.array));
+            return out; // merge() switches it to a bitmap if it grew past kArrayMax
+        }
+        // At least one bitmap: start from it and OR the other side in
+        Container out = a.is_bitmap ? a : b;
+        const Container &other = a.is_bitmap ? b : a;
+        if (other.is_bitmap)
+        {
+            for (std::size_t w = 0; w < 1024; w++)
+            {
+                out.bitmap[w] |= other.bitmap[w];
+            }
+        }
+        else
+        {
+            for (uint16_t v : other.array)
+            {
+                out.bitmap[v / 64] |= uint64_t{1} << (v % 64);
+            }
+        }
+        return out;
+    }
+
+    // a minus b
+    static Container subtract(const Container &a, const Container &b)
+    {
+        Container out;
+        out.key = a.key;
+        if (a.is_bitmap)
+        {
+            out.is_bitmap = true;
+            out.bitmap = a.bitmap;
+            if (b.is_bitmap)
+            {
+                for (std::size_t w = 0; w < 1024; w++)
+                {
+                    out.bitmap[w] &= ~b.bitmap[w];
+                }
+            }
+            else
+            {
+                for (uint16_t v : b.array)
+                {
+                    out.bitmap[v / 64] &= ~(uint64_t{1} << (v % 64));
+                }
+            }
+        }
+        else if (b.is_bitmap)
+        {
+            for (uint16_t v : a.array)
+            {
+                if (!has(b, v))
+                {
+                    out.array.push_back(v);
+                }
+            }
+        }
+        else
+        {
+            std::set_difference(a.array.begin(), a.array.end(), b.array.begin(), b.array.end(),
+                                std::back_inserter(out.array));
+        }
+        return out;
+    }
+
+    // Keeps the invariant: no empty chunks, arrays only up to kArrayMax, bitmaps only above it
+    void append(Container c)
+    {
+        std::size_t n = count(c);
+        if (n == 0)
+        {
+            return;
+        }
+        if (c.is_bitmap && n <= kArrayMax)
+        {
+            to_array(c);
+        }
+        else if (!c.is_bitmap && n > kArrayMax)
+        {
+            to_bitmap(c);
+        }
+        containers_.push_back(std::move(c));
+    }
+
+    RoaringBitmap merge(const RoaringBitmap &rhs, Container (*both)(const Container &, const Container &),
+                        bool keep_left_only, bool keep_right_only) const
+    {
+        RoaringBitmap out;
+        std::size_t i = 0, j = 0;
+        while (i < containers_.size() || j < rhs.containers_.size())
+        {
+            if (j == rhs.containers_.size() || (i < containers_.size() && containers_[i].key < rhs.containers_[j].key))
+            {
+                if (keep_left_only)
+                {
+                    out.containers_.push_back(containers_[i]);
+                }
+                i++;
+            }
+            else if (i == containers_.size() || rhs.containers_[j].key < containers_[i].key)
+            {
+                if (keep_right_only)
+                {
+                    out.containers_.push_back(rhs.containers_[j]);
+                }
+                j++;
+            }
+            else
+            {
+                out.append(both(containers_[i], rhs.containers_[j]));
+                i++;
+                j++;
+            }
+        }
+        return out;
+    }
+
+    Container &container_for(uint16_t key)
+    {
+        auto it = std::lower_bound(containers_.begin(), containers_.end(), key,
+                                   [](const Container &c, uint16_t k)
+                                   { return c.key < k; });
+        if (it == containers_.end() || it->key != key)
+        {
+            it = containers_.insert(it, Container{});
+            it->key = key;
+        }
+        return *it;
+    }
+
+    const Container *find_container(uint16_t key) const
+    {
+        auto it = std::lower_bound(containers_.begin(), containers_.end(), key,
+                                   [](const Container &c, uint16_t k)
+                                   { return c.key < k; });
+        return it != containers_.end() && it->key == key ? &*it : nullptr;
+    }
+
+    std::vector<Container> containers_; // sorted by key
+};
+
+// ------------------------ BENCHMARK -----------------------------
+
+template <typename F>
+double time_ms(F &&f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+int main(int argc, char *argv[])
+{
+    // Default 100M rows (two int32 columns = 800 MB); pass 1000000000 for 1B if you have ~8 GB free
+    std::size_t n = argc > 1 ? std::stoul(argv[1]) : 100'000'000;
+    std::vector<int32_t> a(n), b(n);
+    std::mt19937 rng(3);
+    for (std::size_t i = 0; i < n; i++)
+    {
+        a[i] = static_cast<int32_t>(rng() % 1000);
+        b[i] = static_cast<int32_t>(rng() % 1000);
+    }
+
+    // ---------------------- BRANCHY: like 08conditions.cpp ------------------------
+    std::size_t branchy = 0;
+    double branchy_ms = time_ms([&]
+                                {
+        for (std::size_t i = 0; i < n; i++)
+        {
+            if (a[i] > 500)
+            {
+                if (b[i] > 300)
+                {
+                    branchy++;
+                }
+            }
+        } });
+
+    // ---------------------- BITMAPS: predicate → bits → AND → popcount ------------------------
+    DenseBitset bits_a, bits_b;
+    double build_ms = time_ms([&]
+                              {
+        bits_a = bits_greater(a, 500);
+        bits_b = bits_greater(b, 300); });
+    std::size_t bitwise = 0;
+    double combine_ms = time_ms([&]
+                                {
+        bits_a &= bits_b;
+        bitwise = bits_a.count(); });
+
+    std::cout << n / 1'000'000 << "M rows, count(a > 500 && b > 300)\n";
+    std::cout << "  branchy loop:            " << branchy_ms << " ms → " << branchy << '\n';
+    std::cout << "  build 2 bitsets:         " << build_ms << " ms\n";
+    std::cout << "  AND + popcount:          " << combine_ms << " ms → " << bitwise << "\n";
+
+    // Iterate matching row ids (first few)
+    std::cout << "  first matching rows:    ";
+    std::size_t shown = 0;
+    bits_a.for_each_set([&](std::size_t row)
+                        {
+        if (shown++ < 5)
+        {
+            std::cout << ' ' << row;
+        } });
+    std::cout << "\n\n";
+
+    // ---------------------- ROARING: sparse sets ------------------------
+    DenseBitset rare = bits_greater(a, 998); // ~0.1% of rows
+    RoaringBitmap roaring_rare = RoaringBitmap::from_dense(rare);
+    RoaringBitmap roaring_ab = RoaringBitmap::from_dense(bits_a);
+    RoaringBitmap both = roaring_rare & roaring_ab;
+
+    std::cout << "Roaring (a > 998): " << roaring_rare.cardinality() << " rows in "
+              << roaring_rare.bytes() / 1024 << " KB vs dense " << n / 8 / 1024 << " KB\n";
+    // Cross-check with the dense version of the same intersection
+    DenseBitset dense_both = rare;
+    dense_both &= bits_a;
+    std::size_t first_row = 0;
+    bool found = false;
+    dense_both.for_each_set([&](std::size_t row)
+                            {
+        if (!found)
+        {
+            first_row = row;
+            found = true;
+        } });
+    std::cout << "Roaring AND result: " << both.cardinality() << " rows (dense: " << dense_both.count()
+              << "), contains(" << first_row << ")? " << both.contains(static_cast<uint32_t>(first_row)) << '\n';
+
+    // OR / ANDNOT, and for_each must list exactly the dense set bits
+    DenseBitset dense_or = rare, dense_andnot = rare;
+    dense_or |= bits_a;
+    dense_andnot.and_not(bits_a);
+    RoaringBitmap either = roaring_rare | roaring_ab;
+    RoaringBitmap only_rare = roaring_rare.and_not(roaring_ab);
+    std::vector<uint32_t> listed, expected;
+    only_rare.for_each([&](uint32_t row)
+                       { listed.push_back(row); });
+    dense_andnot.for_each_set([&](std::size_t row)
+                              { expected.push_back(static_cast<uint32_t>(row)); });
+    std::cout << "Roaring OR: " << either.cardinality() << " rows (dense: " << dense_or.count()
+              << "), ANDNOT: " << only_rare.cardinality() << " rows (dense: " << dense_andnot.count() << ")"
+              << (listed == expected && either.cardinality() == dense_or.count() ? ", for_each agrees" : "  MISMATCH")
+              << '\n';
+
+    try
+    {
+        DenseBitset shorter(n / 2);
+        shorter &= bits_a; // different row counts: no silent partial AND
+    }
+    catch (const std::invalid_argument &e)
+    {
+        std::cout << "Rejected: " << e.what() << '\n';
+    }
+
+#if defined(__AVX2__)
+    std::cout << "\nAVX2 kernels enabled\n";
+#else
+    std::cout << "\nScalar kernels (compile with -march=native for AVX2)\n";
+#endif
+    return 0;
+}
+
+/*
+----------------------------------------------------------------------
+KEY TAKEAWAYS:
+----------------------------------------------------------------------
+1. A comparison produces 0 or 1. Shifting that into a word
+   (word |= uint64_t(x > t) << j) filters WITHOUT branches, so nothing can
+   be mispredicted.
+
+2. With AVX2, _mm256_cmpgt_epi32 compares 8 ints and _mm256_movemask_ps
+   packs the 8 results into 8 bits.
+
+3. Once predicates are bits, AND/OR/ANDNOT combine 256 rows per
+   instruction and std::popcount counts 64 rows per instruction.
+
+4. `word &= word - 1` clears the lowest set bit; with std::countr_zero it
+   walks only the matching rows.
+
+5. Roaring bitmaps pick array or bitmap storage per 65536-row chunk, so
+   sparse sets stay tiny while dense chunks keep bitmap speed. AND, OR and
+   ANDNOT are one merge over the sorted chunk keys, with a kernel for
+   each pair of array/bitmap containers.
+
+- How to Run:
+    g++ 46bitmap_index.cpp -o bitmap --std=c++20 -O2 -march=native
+----------------------------------------------------------------------
+*/
@@ -0,0 +1,302 @@
+#include <iostream>  // For std::cout
+#include <vector>    // For input and output columns
+#include <span>      // For the filter API (see 24std_span.cpp)
+#include <array>     // For the shuffle lookup table
+#include <cstdint>   // For int32_t
+#include <bit>       // For std::popcount
+#include <random>    // For random data
+#include <chrono>    // For timing
+#include <algorithm> // For std::equal
+#include <stdexcept> // For std::length_error
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h> // AVX2 permute / AVX-512 compress-store
+#endif
+
+/*
+----------------------------------------------------------------------
+TOPIC: BRANCHLESS FILTERING (stream compaction)
+----------------------------------------------------------------------
+08conditions.cpp picks a path with if/else. A filter loop does the same
+for every element:
+
+    for (x : in) if (x > t) out[k++] = x;     // "branchy"
+
+The CPU GUESSES which way each `if` goes. With random data and ~50%
+selectivity it guesses wrong half of the time, and every wrong guess
+throws away ~15 cycles of work.
+
+Branchless version: ALWAYS write, but only advance when it matched:
+
+    for (x : in) { out[k] = x; k += (x > t); }
+
+The comparison is now plain arithmetic (0 or 1), so there is nothing to
+mispredict. Cost: one store per element even when nothing matches.
+
+SIMD versions take 8 (AVX2) or 16 (AVX-512) elements at a time:
+- compare all lanes → a bit mask (e.g. 0b10010110)
+- AVX-512 has a "compress store" instruction that writes only the
+  selected lanes, packed together.
+- AVX2 doesn't, so we precompute for each of the 256 possible 8-bit
+  masks a permutation that moves selected lanes to the front
+  (a lookup table), permute, store all 8 lanes, advance by popcount(mask).
+
+Which one is fastest depends on SELECTIVITY (fraction that passes):
+- ~0% or ~100%: branches are perfectly predicted → branchy is cheapest.
+- in between: branchless / SIMD win by a lot.
+So filter() samples the data first and picks a path.
+----------------------------------------------------------------------
+*/
+
+// ------------------------ SCALAR KERNELS -----------------------------
+
+/*
+Every kernel below may write up to in.size() elements (the branchless and
+SIMD ones write junk past the kept count), so `out` must be at least as
+long as `in`. Checked once per call, never inside the loops.
+*/
+template <typename T>
+void require_room(std::span<const T> in, std::span<T> out)
+{
+    if (out.size() < in.size())
+    {
+        throw std::length_error("filter: out must have room for in.size() elements");
+    }
+}
+
+template <typename T, typename Pred>
+std::size_t filter_branchy(std::span<const T> in, Pred pred, std::span<T> out)
+{
+    require_room(in, out);
+    std::size_t k = 0;
+    for (const T &x : in)
+    {
+        if (pred(x))
+        {
+            out[k++] = x;
+        }
+    }
+    return k;
+}
+
+template <typename T, typename Pred>
+std::size_t filter_branchless(std::span<const T> in, Pred pred, std::span<T> out)
+{
+    require_room(in, out);
+    std::size_t k = 0;
+    T *dst = out.data();
+    for (const T &x : in)
+    {
+        dst[k] = x;                              // always store...
+        k += static_cast<std::size_t>(pred(x)); // ...but only keep it if it matched
+    }
+    return k;
+}
+
+// ------------------------ ADAPTIVE GENERIC FILTER -----------------------------
+
+/*
+Estimates selectivity on a sample, then picks branchy for very low / very
+high selectivity and branchless otherwise.
+`out` must have room for in.size() elements.
+*/
+template <typename T, typename Pred>
+std::size_t filter(std::span<const T> in, Pred pred, std::span<T> out)
+{
+    require_room(in, out);
+    constexpr std::size_t kSample = 1024;
+    std::size_t sample = std::min(kSample, in.size());
+    std::size_t hits = 0;
+    for (std::size_t i = 0; i < sample; i++)
+    {
+        hits += static_cast<std::size_t>(pred(in[i * (in.size() / sample)]));
+    }
+    double selectivity = sample ? static_cast<double>(hits) / sample : 0.0;
+
+    if (selectivity < 0.02 || selectivity > 0.98)
+    {
+        return filter_branchy(in, pred, out);
+    }
+    return filter_branchless(in, pred, out);
+}
+
+// ------------------------ SIMD KERNELS FOR int32 > threshold -----------------------------
+
+#if defined(__AVX2__)
+// For every 8-bit mask: lane indices of the set bits, packed to the front
+constexpr std::array<std::array<int32_t, 8>, 256> make_compress_lut()
+{
+    std::array<std::array<int32_t, 8>, 256> lut{};
+    for (int mask = 0; mask < 256; mask++)
+    {
+        int k = 0;
+        for (int lane = 0; lane < 8; lane++)
+        {
+            if (mask & (1 << lane))
+            {
+                lut[mask][k++] = lane;
+            }
+        }
+        // remaining entries stay 0: those lanes are junk and get overwritten later
+    }
+    return lut;
+}
+
+constexpr auto kCompressLut = make_compress_lut(); // 8 KB, computed at compile time
+
+std::size_t filter_greater_avx2(std::span<const int32_t> in, int32_t threshold, std::span<int32_t> out)
+{
+    require_room(in, out);
+    std::size_t k = 0, i = 0;
+    __m256i t = _mm256_set1_epi32(threshold);
+    for (; i + 8 <= in.size(); i += 8)
+    {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in.data() + i));
+        int mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(v, t)));
+        __m256i perm = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(kCompressLut[mask].data()));
+        // k <= i, so writing 8 lanes at out + k stays inside out[0, in.size())
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out.data() + k), _mm256_permutevar8x32_epi32(v, perm));
+        k += static_cast<std::size_t>(std::popcount(static_cast<unsigned>(mask)));
+    }
+    for (; i < in.size(); i++)
+    {
+        out[k] = in[i];
+        k += in[i] > threshold;
+    }
+    return k;
+}
+#endif
+
+#if defined(__AVX512F__)
+std::size_t filter_greater_avx512(std::span<const int32_t> in, int32_t threshold, std::span<int32_t> out)
+{
+    require_room(in, out);
+    std::size_t k = 0, i = 0;
+    __m512i t = _mm512_set1_epi32(threshold);
+    for (; i + 16 <= in.size(); i += 16)
+    {
+        __m512i v = _mm512_loadu_si512(in.data() + i);
+        __mmask16 mask = _mm512_cmpgt_epi32_mask(v, t);
+        _mm512_mask_compressstoreu_epi32(out.data() + k, mask, v); // writes only selected lanes
+        k += static_cast<std::size_t>(std::popcount(static_cast<unsigned>(mask)));
+    }
+    for (; i < in.size(); i++)
+    {
+        out[k] = in[i];
+        k += in[i] > threshold;
+    }
+    return k;
+}
+#endif
+
+// Best available kernel for `x > threshold` on int32
+std::size_t filter_greater(std::span<const int32_t> in, int32_t threshold, std::span<int32_t> out)
+{
+    require_room(in, out);
+#if defined(__AVX512F__)
+    return filter_greater_avx512(in, threshold, out);
+#elif defined(__AVX2__)
+    return filter_greater_avx2(in, threshold, out);
+#else
+    return filter(in, [threshold](int32_t x)
+                  { return x > threshold; },
+                  out);
+#endif
+}
+
+// ------------------------ BENCHMARK -----------------------------
+
+template <typename F>
+double time_ms(F &&f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+int main()
+{
+    constexpr std::size_t kN = 20'000'000;
+    std::vector<int32_t> in(kN);
+    std::mt19937 rng(5);
+    for (auto &x : in)
+    {
+        x = static_cast<int32_t>(rng() % 100); // 0..99 → threshold t keeps (99 - t)%
+    }
+    std::vector<int32_t> out_a(kN), out_b(kN), out_c(kN), out_d(kN);
+    std::span<const int32_t> input(in);
+    filter_branchless<int32_t>(input, [](int32_t x)
+                               { return x > 50; },
+                               out_a); // warm-up: first pass pays for cold caches
+
+#if defined(__AVX512F__)
+    const char *simd = "AVX-512 compress";
+#elif defined(__AVX2__)
+    const char *simd = "AVX2 LUT shuffle";
+#else
+    const char *simd = "scalar (no SIMD)";
+#endif
+
+    std::cout << kN / 1'000'000 << "M ints, time in ms. SIMD kernel: " << simd << "\n\n";
+    std::cout << "select%  branchy  branchless  adaptive  simd\n";
+    for (int keep : {1, 10, 25, 50, 75, 90, 99})
+    {
+        int32_t t = 99 - keep; // x > t keeps `keep` values out of 100
+        auto pred = [t](int32_t x)
+        { return x > t; };
+
+        std::size_t na = 0, nb = 0, nc = 0, nd = 0;
+        double a = time_ms([&]
+                           { na = filter_branchy<int32_t>(input, pred, out_a); });
+        double b = time_ms([&]
+                           { nb = filter_branchless<int32_t>(input, pred, out_b); });
+        double c = time_ms([&]
+                           { nc = filter<int32_t>(input, pred, out_c); });
+        double d = time_ms([&]
+                           { nd = filter_greater(input, t, out_d); });
+
+        bool same = na == nb && nb == nc && nc == nd &&
+                    std::equal(out_a.begin(), out_a.begin() + static_cast<std::ptrdiff_t>(na), out_d.begin());
+        std::cout << "  " << keep << "%\t " << a << "\t  " << b << "\t" << c << "\t  " << d
+                  << (same ? "" : "  MISMATCH") << '\n';
+    }
+
+    std::vector<int32_t> small_out(10);
+    try
+    {
+        filter_greater(input, 50, small_out);
+    }
+    catch (const std::length_error &e)
+    {
+        std::cout << "\nout too small rejected: " << e.what() << '\n';
+    }
+    return 0;
+}
+
+/*
+----------------------------------------------------------------------
+KEY TAKEAWAYS:
+----------------------------------------------------------------------
+1. Branch mispredictions, not arithmetic, dominate filters on random data
+   with medium selectivity.
+
+2. Branchless trick: store unconditionally, advance the output index by
+   the 0/1 result of the predicate.
+
+3. SIMD compaction:
+   - AVX-512: _mm512_mask_compressstoreu_epi32 does it in one instruction.
+   - AVX2: compare → movemask → 256-entry permutation table (built with a
+     constexpr function) → _mm256_permutevar8x32_epi32 → store 8 lanes,
+     advance by popcount(mask).
+
+4. Adaptive: at ~1% or ~99% the branch predictor is almost always right,
+   so the branchy loop (fewer stores) can win. Sample first, then choose.
+
+5. The output span must have room for in.size() elements: the branchless
+   and SIMD kernels write past the final count before it's known.
+
+- How to Run:
+    g++ 47stream_compaction.cpp -o compact --std=c++20 -O2 -march=native
+----------------------------------------------------------------------
+*/
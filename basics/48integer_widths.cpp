@@ -0,0 +1,423 @@
+#include <iostream>    // For std::cout
+#include <vector>      // For columns
+#include <span>        // For the kernel API (see 24std_span.cpp)
+#include <array>       // For histogram bins
+#include <variant>     // For the narrow column storage
+#include <cstdint>     // For int8_t ... int64_t (see 06integers.cpp)
+#include <limits>      // For std::numeric_limits
+#include <type_traits> // For std::make_unsigned_t
+#include <stdexcept>   // For std::overflow_error
+#include <algorithm>   // For std::sort, std::min, std::max
+#include <random>      // For test data
+#include <chrono>      // For timing
+
+/*
+----------------------------------------------------------------------
+TOPIC: PICKING THE RIGHT INTEGER WIDTH
+----------------------------------------------------------------------
+06integers.cpp shows that int8_t / int16_t / int32_t / int64_t take 1, 2,
+4 and 8 bytes. Why care?
+
+1. SIMD: a 256-bit register holds 32 int8, 16 int16, 8 int32 or 4 int64.
+   A narrower type means more elements per instruction.
+2. Memory bandwidth: a scan over 100M values reads 100 MB as int8 but
+   800 MB as int64. Big scans are limited by bandwidth, so that's ~8x.
+3. Sorting: a radix sort needs one pass per byte, so int8 sorts in 1 pass,
+   int64 in 8.
+
+The catch is OVERFLOW: summing int8 values in an int8 wraps after a few
+elements. Kernels here accumulate in a wider type, but only as wide as
+needed, and only for as many elements as can't overflow:
+
+    int8  → sum blocks of 256 in int16 lanes   (127 * 256   <  32767)
+    int16 → sum blocks of 65536 in int32 lanes (32767 * 65536 < 2^31)
+    int32 → sum in int64 (can't overflow for < 2^32 elements)
+    int64 → sum in int64 with an overflow CHECK (throws on overflow)
+
+Last part: NarrowColumn looks at min/max of int64 data and stores it in
+the narrowest type that fits ("downcasting" the storage).
+----------------------------------------------------------------------
+*/
+
+// ------------------------ WIDENING RULES -----------------------------
+
+// Accumulator type for a block, and how many elements a block may hold
+template <typename T>
+struct Widen;
+
+template <>
+struct Widen<int8_t>
+{
+    using acc = int16_t;
+    static constexpr std::size_t block = 256;
+};
+
+template <>
+struct Widen<int16_t>
+{
+    using acc = int32_t;
+    static constexpr std::size_t block = 65536;
+};
+
+template <>
+struct Widen<int32_t>
+{
+    using acc = int64_t;
+    static constexpr std::size_t block = std::size_t{1} << 32;
+};
+
+// Sanity check of the table above at compile time
+template <typename T>
+constexpr bool block_cannot_overflow()
+{
+    using A = typename Widen<T>::acc;
+    // worst case: every element is the most negative value
+    return static_cast<long double>(Widen<T>::block) * std::numeric_limits<T>::min() >=
+           std::numeric_limits<A>::min();
+}
+static_assert(block_cannot_overflow<int8_t>());
+static_assert(block_cannot_overflow<int16_t>());
+static_assert(block_cannot_overflow<int32_t>());
+
+// ------------------------ KERNELS -----------------------------
+
+// Sum of 8/16/32-bit ints: narrow per-block accumulator, then widened to int64
+template <typename T>
+int64_t sum(std::span<const T> data)
+{
+    using A = typename Widen<T>::acc;
+    constexpr std::size_t kBlock = std::min<std::size_t>(Widen<T>::block, 4096);
+    int64_t total = 0;
+    std::size_t i = 0;
+    for (; i + kBlock <= data.size(); i += kBlock)
+    {
+        A block_sum = 0; // narrow → the compiler packs more lanes per register
+        const T *p = data.data() + i;
+        for (std::size_t j = 0; j < kBlock; j++) // constant trip count: vectorizes even at -O2
+        {
+            block_sum = static_cast<A>(block_sum + p[j]);
+        }
+        total += block_sum;
+    }
+    for (; i < data.size(); i++) // tail is shorter than a block: int64 directly
+    {
+        total += data[i];
+    }
+    return total;
+}
+
+// int64 has nothing wider to go to (portably), so we check every add
+template <>
+int64_t sum<int64_t>(std::span<const int64_t> data)
+{
+    int64_t total = 0;
+    for (int64_t x : data)
+    {
+        if (__builtin_add_overflow(total, x, &total))
+        {
+            throw std::overflow_error("sum<int64_t> overflowed");
+        }
+    }
+    return total;
+}
+
+template <typename T>
+std::pair<T, T> min_max(std::span<const T> data)
+{
+    constexpr std::size_t kBlock = 1024;
+    T lo = std::numeric_limits<T>::max();
+    T hi = std::numeric_limits<T>::min();
+    std::size_t i = 0;
+    for (; i + kBlock <= data.size(); i += kBlock)
+    {
+        const T *p = data.data() + i;
+        for (std::size_t j = 0; j < kBlock; j++) // vectorizes to pminsb/pmaxsb, pminsw/pmaxsw, ...
+        {
+            lo = std::min(lo, p[j]);
+            hi = std::max(hi, p[j]);
+        }
+    }
+    for (; i < data.size(); i++)
+    {
+        lo = std::min(lo, data[i]);
+        hi = std::max(hi, data[i]);
+    }
+    return {lo, hi};
+}
+
+/*
+Exact histogram of every possible value, so only for 8- and 16-bit types.
+Four sub-histograms: consecutive equal values would otherwise wait on each
+other's increment (store → load of the same counter).
+*/
+template <typename T>
+std::vector<uint32_t> histogram(std::span<const T> data)
+{
+    static_assert(sizeof(T) <= 2, "exact histogram needs at most 2^16 bins");
+    using U = std::make_unsigned_t<T>;
+    constexpr std::size_t kBins = std::size_t{1} << (8 * sizeof(T));
+
+    std::vector<uint32_t> sub(4 * kBins, 0);
+    std::size_t i = 0;
+    for (; i + 4 <= data.size(); i += 4)
+    {
+        sub[0 * kBins + static_cast<U>(data[i + 0])]++;
+        sub[1 * kBins + static_cast<U>(data[i + 1])]++;
+        sub[2 * kBins + static_cast<U>(data[i + 2])]++;
+        sub[3 * kBins + static_cast<U>(data[i + 3])]++;
+    }
+    for (; i < data.size(); i++)
+    {
+        sub[static_cast<U>(data[i])]++;
+    }
+
+    // bin b counts value b - min, e.g. for int8 bin 0 is -128
+    std::vector<uint32_t> bins(kBins);
+    constexpr U kBias = U{1} << (8 * sizeof(T) - 1);
+    for (std::size_t v = 0; v < kBins; v++)
+    {
+        U biased = static_cast<U>(static_cast<U>(v) ^ kBias); // flip sign bit
+        bins[biased] = sub[v] + sub[kBins + v] + sub[2 * kBins + v] + sub[3 * kBins + v];
+    }
+    return bins;
+}
+
+/*
+LSD radix sort, one pass per byte: sizeof(T) passes.
+Signed values: flip the sign bit so negatives order before positives.
+*/
+template <typename T>
+void radix_sort(std::span<T> data)
+{
+    using U = std::make_unsigned_t<T>;
+    constexpr U kSign = U{1} << (8 * sizeof(T) - 1);
+    std::vector<T> tmp(data.size());
+    std::span<T> src = data, dst = tmp;
+
+    for (std::size_t pass = 0; pass < sizeof(T); pass++)
+    {
+        unsigned shift = static_cast<unsigned>(pass * 8);
+        std::array<std::size_t, 256> count{};
+        for (T x : src)
+        {
+            count[(static_cast<U>(static_cast<U>(x) ^ kSign) >> shift) & 0xFF]++;
+        }
+        std::size_t offset = 0;
+        for (auto &c : count) // counts → starting offsets
+        {
+            std::size_t n = c;
+            c = offset;
+            offset += n;
+        }
+        for (T x : src)
+        {
+            dst[count[(static_cast<U>(static_cast<U>(x) ^ kSign) >> shift) & 0xFF]++] = x;
+        }
+        std::swap(src, dst);
+    }
+    if (src.data() != data.data()) // odd number of passes: result is in tmp
+    {
+        std::copy(src.begin(), src.end(), data.begin());
+    }
+}
+
+// ------------------------ NARROWEST-TYPE COLUMN -----------------------------
+
+/*
+Stores int64 data in int8/16/32/64, whichever is the smallest that holds
+[min, max]. Reads widen back to int64.
+*/
+class NarrowColumn
+{
+public:
+    using Storage = std::variant<std::vector<int8_t>, std::vector<int16_t>,
+                                 std::vector<int32_t>, std::vector<int64_t>>;
+
+    static NarrowColumn from(std::span<const int64_t> values)
+    {
+        auto [lo, hi] = values.empty() ? std::pair<int64_t, int64_t>{0, 0} : min_max(values);
+        if (fits<int8_t>(lo, hi))
+            return NarrowColumn(narrow<int8_t>(values));
+        if (fits<int16_t>(lo, hi))
+            return NarrowColumn(narrow<int16_t>(values));
+        if (fits<int32_t>(lo, hi))
+            return NarrowColumn(narrow<int32_t>(values));
+        return NarrowColumn(std::vector<int64_t>(values.begin(), values.end()));
+    }
+
+    int64_t at(std::size_t i) const
+    {
+        return std::visit([i](const auto &v)
+                          { return static_cast<int64_t>(v[i]); },
+                          storage_);
+    }
+
+    int64_t sum() const
+    {
+        return std::visit([](const auto &v)
+                          { return ::sum(std::span(v.data(), v.size())); },
+                          storage_);
+    }
+
+    std::size_t size() const
+    {
+        return std::visit([](const auto &v)
+                          { return v.size(); },
+                          storage_);
+    }
+
+    std::size_t bytes_per_value() const
+    {
+        return std::visit([](const auto &v)
+                          { return sizeof(v[0]); },
+                          storage_);
+    }
+
+private:
+    explicit NarrowColumn(Storage s) : storage_(std::move(s)) {}
+
+    template <typename T>
+    static bool fits(int64_t lo, int64_t hi)
+    {
+        return lo >= std::numeric_limits<T>::min() && hi <= std::numeric_limits<T>::max();
+    }
+
+    template <typename T>
+    static std::vector<T> narrow(std::span<const int64_t> values)
+    {
+        std::vector<T> out(values.size());
+        for (std::size_t i = 0; i < values.size(); i++)
+        {
+            out[i] = static_cast<T>(values[i]); // safe: fits<T> checked the range
+        }
+        return out;
+    }
+
+    Storage storage_;
+};
+
+// ------------------------ BENCHMARK -----------------------------
+
+template <typename F>
+double time_ms(F &&f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+template <typename T>
+std::vector<T> random_values(std::size_t n, int64_t lo, int64_t hi)
+{
+    std::mt19937_64 rng(11);
+    std::uniform_int_distribution<int64_t> dist(lo, hi);
+    std::vector<T> v(n);
+    for (auto &x : v)
+    {
+        x = static_cast<T>(dist(rng));
+    }
+    return v;
+}
+
+// Same values (-100..100) stored at width T: only the storage width changes
+template <typename T>
+void bench_width(const char *name, std::size_t n)
+{
+    auto v = random_values<T>(n, -100, 100);
+    std::span<const T> s(v);
+
+    int64_t total = 0;
+    double t_sum = time_ms([&]
+                           { total = sum(s); });
+    std::pair<T, T> mm{};
+    double t_mm = time_ms([&]
+                          { mm = min_max(s); });
+    auto sorted = v;
+    double t_radix = time_ms([&]
+                             { radix_sort(std::span<T>(sorted)); });
+    auto reference = v;
+    double t_std = time_ms([&]
+                           { std::sort(reference.begin(), reference.end()); });
+
+    std::cout << name << "\t" << n * sizeof(T) / (1 << 20) << " MB\tsum " << t_sum
+              << "\tmin/max " << t_mm << "\tradix " << t_radix << "\tstd::sort " << t_std
+              << "\t(sum=" << total << ", " << +mm.first << ".." << +mm.second
+              << (sorted == reference ? ", sorted ok)" : ", SORT MISMATCH)") << '\n';
+}
+
+int main(int argc, char **argv)
+{
+    std::size_t n = argc > 1 ? std::stoull(argv[1]) : 20'000'000;
+
+    // 1. Overflow handling
+    std::vector<int8_t> big(1'000'000, 127); // 127'000'000 would wrap in int8 or int16
+    std::cout << "sum of 1M x int8 127 = " << sum(std::span<const int8_t>(big)) << '\n';
+    std::vector<int64_t> huge = {std::numeric_limits<int64_t>::max(), 1};
+    try
+    {
+        sum(std::span<const int64_t>(huge));
+    }
+    catch (const std::overflow_error &e)
+    {
+        std::cout << "int64 overflow detected: " << e.what() << "\n";
+    }
+
+    // 2. Histogram
+    auto h = random_values<int8_t>(1'000'000, -3, 3);
+    auto bins = histogram(std::span<const int8_t>(h));
+    std::cout << "int8 histogram of -3..3: ";
+    for (int v = -3; v <= 3; v++)
+    {
+        std::cout << v << ":" << bins[static_cast<std::size_t>(v + 128)] << ' ';
+    }
+    std::cout << "\n\n";
+
+    // 3. Same data, different widths (ms)
+    bench_width<int8_t>("int8 ", n);
+    bench_width<int16_t>("int16", n);
+    bench_width<int32_t>("int32", n);
+    bench_width<int64_t>("int64", n);
+
+    // 4. Narrowest-type column
+    auto raw = random_values<int64_t>(n, 0, 1000); // fits int16
+    NarrowColumn col = NarrowColumn::from(raw);
+    int64_t a = 0, b = 0;
+    double t_wide = time_ms([&]
+                            { a = sum(std::span<const int64_t>(raw)); });
+    double t_narrow = time_ms([&]
+                              { b = col.sum(); });
+    std::cout << "\nNarrowColumn: 0..1000 stored as " << col.bytes_per_value() * 8 << "-bit ("
+              << raw.size() * 8 / (1 << 20) << " MB -> " << col.size() * col.bytes_per_value() / (1 << 20)
+              << " MB), sum int64 " << t_wide << " ms vs narrow " << t_narrow << " ms"
+              << (a == b ? "" : "  MISMATCH") << ", at(0) = " << col.at(0) << " (raw " << raw[0] << ")\n";
+    return 0;
+}
+
+/*
+----------------------------------------------------------------------
+KEY TAKEAWAYS:
+----------------------------------------------------------------------
+1. Narrow types = more values per SIMD register and per byte of memory
+   bandwidth. Use int8/int16 when the value range allows it.
+
+2. Widen the ACCUMULATOR only as far as needed, and sum in blocks small
+   enough that the narrow accumulator can't overflow; then add the block
+   results into int64. static_assert checks the block sizes.
+
+3. int64 has no wider portable type: check with __builtin_add_overflow
+   and throw std::overflow_error.
+
+4. At -O2 GCC only vectorizes loops it finds cheap, e.g. a CONSTANT trip
+   count. Inner loops over fixed-size blocks + a scalar tail get there.
+
+5. Radix sort does sizeof(T) passes, so narrow keys sort faster.
+
+6. NarrowColumn picks the narrowest width from min/max once, at load
+   time, and widens on read. Same answers, 2-8x less memory traffic.
+
+- How to Run:
+    g++ 48integer_widths.cpp -o widths --std=c++20 -O2 -march=native
+    ./widths 100000000   // optional element count
+----------------------------------------------------------------------
+*/
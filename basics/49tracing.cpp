@@ -0,0 +1,398 @@
+#include <iostream>  // For std::cout
+#include <fstream>   // For writing the trace file
+#include <vector>    // For workloads and the buffer registry
+#include <memory>    // For std::unique_ptr (see 22unique_ptr_part1.cpp)
+#include <span>      // For the traced_* wrappers (see 24std_span.cpp)
+#include <atomic>    // For the per-thread event and drop counts
+#include <mutex>     // For registering a thread's buffer (once)
+#include <thread>    // For the multi-threaded demo
+#include <algorithm> // For std::sort, std::copy
+#include <numeric>   // For std::accumulate
+#include <cstdint>   // For uint64_t
+#include <random>    // For demo data
+#include <chrono>    // For the clock fallback / calibration
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h> // For __rdtsc
+#endif
+
+/*
+----------------------------------------------------------------------
+TOPIC: CHEAP TRACING (scoped timers + counters)
+----------------------------------------------------------------------
+So far we "observed" programs with std::cout: print_size() in 33move.cpp,
+use_count() in 23shared_pointer.cpp. Printing in a hot loop is slow
+(locks, formatting, syscalls) and changes what we are measuring.
+
+A tracer instead just RECORDS small fixed-size events in memory:
+
+    { name, start timestamp, duration }
+
+and writes them out once, at the end, in a format a viewer understands.
+Here: Chrome trace JSON → open chrome://tracing or https://ui.perfetto.dev
+and load the file to see a timeline per thread.
+
+Keeping each event cheap (~10-20 ns on bare metal):
+1. Timestamps: rdtsc reads the CPU's cycle counter in a few ns, no
+   syscall. (Some VMs make rdtsc itself cost 20+ ns; main() prints it.)
+   We convert ticks to microseconds only when writing the file.
+2. No locks on the hot path: every thread writes into ITS OWN buffer
+   (thread_local pointer). The lock is taken once per thread, to register
+   the buffer so the writer can find it later.
+3. Names are `const char*` string literals: no copies, no allocation.
+4. Fixed capacity: a full buffer drops events (and counts the drops)
+   instead of reallocating in the middle of a measurement.
+5. Compile-out: build with -DTRACE_ENABLED=0 and the macros become
+   nothing at all.
+----------------------------------------------------------------------
+*/
+
+#ifndef TRACE_ENABLED
+#define TRACE_ENABLED 1
+#endif
+
+// ------------------------ CLOCK -----------------------------
+
+inline uint64_t trace_now()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+// How many trace_now() ticks per microsecond (measured once, ~20 ms)
+double ticks_per_us()
+{
+    static const double value = []
+    {
+        auto t0 = std::chrono::steady_clock::now();
+        uint64_t c0 = trace_now();
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        uint64_t c1 = trace_now();
+        auto t1 = std::chrono::steady_clock::now();
+        return static_cast<double>(c1 - c0) / std::chrono::duration<double, std::micro>(t1 - t0).count();
+    }();
+    return value;
+}
+
+// ------------------------ EVENTS AND PER-THREAD BUFFERS -----------------------------
+
+struct TraceEvent
+{
+    const char *name; // must be a string literal (or otherwise outlive the tracer)
+    uint64_t start;   // ticks
+    uint64_t value;   // duration in ticks ('X') or counter value ('C')
+    char phase;       // 'X' = complete scope, 'C' = counter
+};
+
+class ThreadBuffer
+{
+public:
+    static constexpr std::size_t kCapacity = 1 << 16;
+
+    explicit ThreadBuffer(unsigned tid) : tid_(tid), events_(new TraceEvent[kCapacity]) {}
+
+    // Only the owning thread calls this → no lock, no CAS
+    void record(const char *name, uint64_t start, uint64_t value, char phase)
+    {
+        std::size_t n = count_.load(std::memory_order_relaxed);
+        if (n == kCapacity)
+        {
+            // Single writer, so load + store is enough (no locked RMW);
+            // the atomic only makes the read from dropped() race-free
+            dropped_.store(dropped_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return;
+        }
+        events_[n] = TraceEvent{name, start, value, phase};
+        count_.store(n + 1, std::memory_order_release); // publish the event to the writer
+    }
+
+    std::span<const TraceEvent> events() const
+    {
+        return {events_.get(), count_.load(std::memory_order_acquire)};
+    }
+
+    unsigned tid() const { return tid_; }
+    std::size_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    unsigned tid_;
+    std::unique_ptr<TraceEvent[]> events_;
+    std::atomic<std::size_t> count_{0};
+    std::atomic<std::size_t> dropped_{0};
+};
+
+/*
+Owns every thread's buffer, so events survive after their thread exits.
+*/
+class Tracer
+{
+public:
+    static Tracer &instance()
+    {
+        static Tracer tracer;
+        return tracer;
+    }
+
+    ThreadBuffer &local()
+    {
+        thread_local ThreadBuffer *buffer = nullptr;
+        if (!buffer) // slow path: first event of this thread
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            buffers_.push_back(std::make_unique<ThreadBuffer>(static_cast<unsigned>(buffers_.size())));
+            buffer = buffers_.back().get();
+        }
+        return *buffer;
+    }
+
+    // Call after the traced threads finished (or accept a partial snapshot)
+    bool write_chrome_trace(const char *path)
+    {
+        std::ofstream out(path);
+        if (!out)
+        {
+            return false;
+        }
+        double tpu = ticks_per_us();
+        uint64_t origin = UINT64_MAX;
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto &b : buffers_)
+        {
+            for (const TraceEvent &e : b->events())
+            {
+                origin = std::min(origin, e.start);
+            }
+        }
+
+        out << "{\"traceEvents\":[\n";
+        bool first = true;
+        for (const auto &b : buffers_)
+        {
+            for (const TraceEvent &e : b->events())
+            {
+                out << (first ? "" : ",\n");
+                first = false;
+                out << "{\"name\":\"" << e.name << "\",\"ph\":\"" << e.phase << "\",\"pid\":1,\"tid\":" << b->tid()
+                    << ",\"ts\":" << static_cast<double>(e.start - origin) / tpu;
+                if (e.phase == 'X')
+                {
+                    out << ",\"dur\":" << static_cast<double>(e.value) / tpu << '}';
+                }
+                else
+                {
+                    out << ",\"args\":{\"value\":" << e.value << "}}";
+                }
+            }
+        }
+        out << "\n]}\n";
+        return static_cast<bool>(out);
+    }
+
+    std::size_t total_events()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::size_t n = 0;
+        for (const auto &b : buffers_)
+        {
+            n += b->events().size();
+        }
+        return n;
+    }
+
+    std::size_t total_dropped()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::size_t n = 0;
+        for (const auto &b : buffers_)
+        {
+            n += b->dropped();
+        }
+        return n;
+    }
+
+private:
+    Tracer() = default;
+    std::mutex mutex_;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers_;
+};
+
+// ------------------------ SCOPED TIMER AND MACROS -----------------------------
+
+// Records one 'X' event from construction to destruction (RAII, like unique_ptr)
+class ScopedTimer
+{
+public:
+    explicit ScopedTimer(const char *name) : buffer_(Tracer::instance().local()), name_(name), start_(trace_now()) {}
+    ~ScopedTimer() { buffer_.record(name_, start_, trace_now() - start_, 'X'); }
+
+    ScopedTimer(const ScopedTimer &) = delete;
+    ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+private:
+    ThreadBuffer &buffer_;
+    const char *name_;
+    uint64_t start_;
+};
+
+inline void trace_counter(const char *name, uint64_t value)
+{
+    Tracer::instance().local().record(name, trace_now(), value, 'C');
+}
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+#if TRACE_ENABLED
+#define TRACE_SCOPE(name) ScopedTimer TRACE_CONCAT(trace_scope_, __LINE__)(name)
+#define TRACE_COUNTER(name, value) trace_counter(name, static_cast<uint64_t>(value))
+#else
+#define TRACE_SCOPE(name) ((void)0)
+#define TRACE_COUNTER(name, value) ((void)0)
+#endif
+
+// ------------------------ TRACED OPERATIONS -----------------------------
+
+// Allocation: a scope for the call plus the byte count as a counter
+template <typename T>
+std::unique_ptr<T[]> traced_alloc(std::size_t n)
+{
+    TRACE_SCOPE("alloc");
+    TRACE_COUNTER("alloc_bytes", n * sizeof(T));
+    return std::make_unique<T[]>(n);
+}
+
+template <typename T>
+void traced_copy(std::span<const T> from, std::span<T> to)
+{
+    TRACE_SCOPE("copy");
+    TRACE_COUNTER("copy_bytes", from.size_bytes());
+    std::copy(from.begin(), from.end(), to.begin());
+}
+
+template <typename T>
+void traced_sort(std::span<T> data)
+{
+    TRACE_SCOPE("sort");
+    std::sort(data.begin(), data.end());
+}
+
+template <typename T>
+T traced_reduce(std::span<const T> data)
+{
+    TRACE_SCOPE("reduce");
+    return std::accumulate(data.begin(), data.end(), T{});
+}
+
+// ------------------------ DEMO AND OVERHEAD -----------------------------
+
+long long worker(unsigned seed, std::size_t n, int rounds)
+{
+    TRACE_SCOPE("worker");
+    std::mt19937 rng(seed);
+    long long total = 0;
+    for (int r = 0; r < rounds; r++)
+    {
+        TRACE_SCOPE("round");
+        auto src = traced_alloc<int>(n);
+        auto dst = traced_alloc<int>(n);
+        for (std::size_t i = 0; i < n; i++)
+        {
+            src[i] = static_cast<int>(rng() % 1000);
+        }
+        traced_copy<int>({src.get(), n}, {dst.get(), n});
+        traced_sort<int>({dst.get(), n});
+        total += traced_reduce<int>({dst.get(), n});
+    }
+    return total;
+}
+
+int main(int argc, char **argv)
+{
+    const char *path = argc > 1 ? argv[1] : "/tmp/trace.json";
+    ticks_per_us(); // calibrate before timing anything
+
+    // 1. Per-call overhead of an (empty) traced scope. Two rounds: the first
+    //    also pays for page faults on the fresh buffer, the second is steady state.
+    constexpr int kCalls = 20'000; // 2 rounds stay below the buffer capacity, nothing dropped
+    for (int round = 0; round < 2; round++)
+    {
+        auto t0 = std::chrono::steady_clock::now();
+        for (int i = 0; i < kCalls; i++)
+        {
+            TRACE_SCOPE("empty");
+        }
+        auto t1 = std::chrono::steady_clock::now();
+        double ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / kCalls;
+        std::cout << "TRACE_SCOPE overhead (" << (round == 0 ? "cold" : "warm") << "): " << ns << " ns per scope"
+                  << (TRACE_ENABLED ? "" : " (tracing compiled out)") << '\n';
+    }
+
+    // rdtsc itself: cheap on bare metal, can be much slower inside some VMs
+    volatile uint64_t sink = 0; // volatile: keep the loop from being optimized away
+    auto r0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < kCalls; i++)
+    {
+        sink = sink + trace_now();
+    }
+    auto r1 = std::chrono::steady_clock::now();
+    std::cout << "trace_now(): " << std::chrono::duration<double, std::nano>(r1 - r0).count() / kCalls
+              << " ns per call\n";
+
+    // 2. A few threads doing traced work
+    std::vector<std::thread> threads;
+    std::vector<long long> results(4);
+    for (unsigned t = 0; t < 4; t++)
+    {
+        threads.emplace_back([t, &results]
+                             { results[t] = worker(t, 200'000, 5); });
+    }
+    for (auto &th : threads)
+    {
+        th.join();
+    }
+    std::cout << "Worker checksums: " << results[0] << ' ' << results[1] << ' ' << results[2] << ' ' << results[3] << '\n';
+
+#if TRACE_ENABLED
+    Tracer &tracer = Tracer::instance();
+    std::cout << "Recorded " << tracer.total_events() << " events (" << tracer.total_dropped() << " dropped)\n";
+    if (tracer.write_chrome_trace(path))
+    {
+        std::cout << "Wrote " << path << " → load it in chrome://tracing or ui.perfetto.dev\n";
+    }
+    else
+    {
+        std::cout << "Could not write " << path << '\n';
+    }
+#else
+    (void)path;
+#endif
+    return 0;
+}
+
+/*
+----------------------------------------------------------------------
+KEY TAKEAWAYS:
+----------------------------------------------------------------------
+1. Record now, format later: the hot path stores 32 bytes and returns.
+
+2. Per-thread buffers (thread_local pointer) avoid locks and cache-line
+   ping-pong between threads. A mutex is only taken once per thread.
+
+3. rdtsc is a cheap timestamp; convert ticks → µs once, using a
+   calibration against steady_clock.
+
+4. ScopedTimer is RAII: the destructor records the event, so every return
+   path of a function gets timed.
+
+5. #define TRACE_ENABLED 0 makes TRACE_SCOPE / TRACE_COUNTER disappear,
+   so instrumentation can stay in the code.
+
+- How to Run:
+    g++ 49tracing.cpp -o tracing --std=c++20 -O2 -pthread
+    ./tracing /tmp/trace.json
+    g++ 49tracing.cpp -o tracing --std=c++20 -O2 -pthread -DTRACE_ENABLED=0
+----------------------------------------------------------------------
+*/
@@ -0,0 +1,344 @@
+#include <iostream>  // For std::cout
+#include <iomanip>   // For std::setw
+#include <vector>    // For the workloads (see 17vector.cpp)
+#include <array>     // For one slot per counter
+#include <optional>  // For counters that are not available
+#include <string>    // For error messages
+#include <algorithm> // For std::sort (see 16sort.cpp)
+#include <numeric>   // For std::accumulate
+#include <random>    // For unsorted input
+#include <chrono>    // For wall-clock time next to the counters
+#include <cstdint>   // For uint64_t
+#include <cstring>   // For std::memset, std::strerror
+#include <cerrno>    // For errno
+
+#include <linux/perf_event.h> // For perf_event_attr and PERF_* constants
+#include <sys/ioctl.h>        // For enabling/disabling counters
+#include <sys/syscall.h>      // For SYS_perf_event_open (glibc has no wrapper)
+#include <unistd.h>           // For syscall, read, close
+
+/*
+----------------------------------------------------------------------
+TOPIC: HARDWARE PERFORMANCE COUNTERS (perf_event_open)
+----------------------------------------------------------------------
+17vector.cpp reasons about capacity, 28struct_constructors.cpp about
+sizeof and padding, but a stopwatch only tells us HOW LONG something took,
+not WHY. The CPU has counters that tell us why:
+
+    cycles          clock ticks spent
+    instructions    instructions retired      → IPC = instructions / cycles
+    L1d misses      loads that missed the L1 data cache
+    LLC misses      ... missed the last-level cache (went to RAM)
+    branch misses   mispredicted branches (see 08conditions.cpp)
+    dTLB misses     address translations that missed the TLB
+    page faults     first touches of fresh memory (a SOFTWARE counter)
+
+Linux exposes them through the perf_event_open syscall (what the `perf`
+tool uses). Each counter is a file descriptor: reset, enable, run code,
+disable, read().
+
+Things that can go wrong, and we must handle gracefully:
+- /proc/sys/kernel/perf_event_paranoid too high → EACCES / EPERM.
+  Values ≤ 2 allow counting your own process in user space, which is
+  why we set exclude_kernel = 1.
+- Virtual machines / containers often expose no hardware PMU → ENOENT.
+- More counters than the CPU has registers → the kernel time-shares
+  them ("multiplexing"). We read time_enabled / time_running and scale.
+- Ratios like IPC = instructions / cycles are only meaningful if both
+  counters ran over the SAME time window. So all counters form ONE group
+  (cycles is the leader): the kernel schedules a group all-or-nothing,
+  and a single read returns every member's value.
+A counter that can't be opened simply shows "n/a".
+----------------------------------------------------------------------
+*/
+
+// ------------------------ COUNTER SET -----------------------------
+
+enum Counter
+{
+    Cycles,
+    Instructions,
+    L1dMisses,
+    LlcMisses,
+    BranchMisses,
+    DtlbMisses,
+    PageFaults,
+    kNumCounters
+};
+
+constexpr const char *kCounterNames[kNumCounters] = {"cycles", "instr", "L1d-miss", "LLC-miss", "br-miss", "dTLB-miss", "page-fault"};
+
+// Cache events are encoded as id | (op << 8) | (result << 16)
+constexpr uint64_t cache_event(uint64_t cache, uint64_t op, uint64_t result)
+{
+    return cache | (op << 8) | (result << 16);
+}
+
+struct EventSpec
+{
+    uint32_t type;
+    uint64_t config;
+};
+
+constexpr EventSpec kEventSpecs[kNumCounters] = {
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HW_CACHE, cache_event(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS)},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    {PERF_TYPE_HW_CACHE, cache_event(PERF_COUNT_HW_CACHE_DTLB, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS)},
+    {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS}, // kernel-side count, works even without a PMU
+};
+
+using CounterValues = std::array<std::optional<uint64_t>, kNumCounters>;
+
+/*
+Opens every counter it can for the calling thread, as one event group
+led by the first counter that opens (cycles, when there is a PMU).
+Unavailable counters are remembered (with the reason) and read back as
+std::nullopt.
+*/
+class PerfCounters
+{
+public:
+    PerfCounters()
+    {
+        fds_.fill(-1);
+        for (int c = 0; c < kNumCounters; c++)
+        {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = kEventSpecs[c].type;
+            attr.config = kEventSpecs[c].config;
+            attr.disabled = leader_ < 0 ? 1 : 0; // members follow the leader's enable/disable
+            attr.exclude_kernel = 1;             // allowed with perf_event_paranoid <= 2
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+            // pid 0 = this thread, cpu -1 = any cpu, group = the leader's fd (-1 → become the leader)
+            long fd = syscall(SYS_perf_event_open, &attr, 0, -1, leader_, 0);
+            if (fd < 0)
+            {
+                if (error_.empty())
+                {
+                    error_ = std::string(kCounterNames[c]) + ": " + std::strerror(errno);
+                }
+                continue;
+            }
+            fds_[c] = static_cast<int>(fd);
+            if (leader_ < 0)
+            {
+                leader_ = fds_[c];
+            }
+            members_.push_back(c); // a group read returns values in this order
+        }
+    }
+
+    ~PerfCounters()
+    {
+        for (int fd : fds_)
+        {
+            if (fd >= 0)
+            {
+                close(fd);
+            }
+        }
+    }
+
+    PerfCounters(const PerfCounters &) = delete;
+    PerfCounters &operator=(const PerfCounters &) = delete;
+
+    // One ioctl on the leader resets / enables the whole group at once
+    void start()
+    {
+        if (leader_ >= 0)
+        {
+            ioctl(leader_, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+            ioctl(leader_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        }
+    }
+
+    CounterValues stop()
+    {
+        CounterValues values;
+        if (leader_ < 0)
+        {
+            return values;
+        }
+        ioctl(leader_, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+        // PERF_FORMAT_GROUP layout: nr, time_enabled, time_running, value[nr]
+        uint64_t buf[3 + kNumCounters];
+        ssize_t want = static_cast<ssize_t>((3 + members_.size()) * sizeof(uint64_t));
+        if (read(leader_, buf, sizeof(buf)) != want || buf[2] == 0)
+        {
+            return values; // never scheduled: e.g. the group needs more registers than exist
+        }
+        // The group was multiplexed as a unit: one scale factor for all members
+        double scale = buf[2] < buf[1] ? static_cast<double>(buf[1]) / buf[2] : 1.0;
+        for (std::size_t m = 0; m < members_.size() && m < buf[0]; m++)
+        {
+            values[members_[m]] = static_cast<uint64_t>(static_cast<double>(buf[3 + m]) * scale);
+        }
+        return values;
+    }
+
+    bool any_available() const
+    {
+        return std::any_of(fds_.begin(), fds_.end(), [](int fd)
+                           { return fd >= 0; });
+    }
+
+    // First reason a counter could not be opened ("" if all opened)
+    const std::string &error() const { return error_; }
+
+private:
+    std::array<int, kNumCounters> fds_;
+    int leader_ = -1;
+    std::vector<int> members_; // counter ids in group order
+    std::string error_;
+};
+
+// ------------------------ BENCHMARK RUNNER -----------------------------
+
+struct Measurement
+{
+    double ms;
+    CounterValues counters;
+};
+
+template <typename F>
+Measurement measure(PerfCounters &perf, F &&f)
+{
+    auto t0 = std::chrono::steady_clock::now();
+    perf.start();
+    f();
+    CounterValues values = perf.stop();
+    auto t1 = std::chrono::steady_clock::now();
+    return {std::chrono::duration<double, std::milli>(t1 - t0).count(), values};
+}
+
+void print_header()
+{
+    std::cout << std::left << std::setw(26) << "workload" << std::right << std::setw(9) << "ms";
+    for (const char *name : kCounterNames)
+    {
+        std::cout << std::setw(13) << name;
+    }
+    std::cout << std::setw(7) << "IPC" << '\n';
+}
+
+void print_row(const char *name, const Measurement &m)
+{
+    std::cout << std::left << std::setw(26) << name << std::right << std::setw(9) << std::fixed << std::setprecision(1) << m.ms;
+    for (const auto &v : m.counters)
+    {
+        if (v)
+        {
+            std::cout << std::setw(13) << *v;
+        }
+        else
+        {
+            std::cout << std::setw(13) << "n/a";
+        }
+    }
+    const auto &cyc = m.counters[Cycles];
+    const auto &ins = m.counters[Instructions];
+    if (cyc && ins && *cyc > 0)
+    {
+        std::cout << std::setw(7) << std::setprecision(2) << static_cast<double>(*ins) / *cyc;
+    }
+    else
+    {
+        std::cout << std::setw(7) << "n/a";
+    }
+    std::cout << '\n';
+}
+
+// ------------------------ WORKLOADS -----------------------------
+
+int main(int argc, char **argv)
+{
+    std::size_t n = argc > 1 ? std::stoull(argv[1]) : 10'000'000;
+
+    PerfCounters perf;
+    if (!perf.any_available())
+    {
+        std::cout << "No counters available (" << perf.error() << ").\n"
+                  << "Check /proc/sys/kernel/perf_event_paranoid. Showing wall time only.\n\n";
+    }
+    else if (!perf.error().empty())
+    {
+        std::cout << "Some counters unavailable (first error: " << perf.error() << ").\n"
+                  << "ENOENT usually means no hardware PMU (common in VMs).\n\n";
+    }
+
+    std::vector<int> data(n);
+    std::mt19937 rng(3);
+    for (auto &x : data)
+    {
+        x = static_cast<int>(rng());
+    }
+
+    print_header();
+
+    // sum: streaming, very predictable → high IPC, few misses per element
+    long long total = 0;
+    print_row("sum (accumulate)", measure(perf, [&]
+                                          { total = std::accumulate(data.begin(), data.end(), 0LL); }));
+
+    // sort: random input → many branch misses inside the partition loop
+    std::vector<int> to_sort = data;
+    print_row("std::sort (random)", measure(perf, [&]
+                                            { std::sort(to_sort.begin(), to_sort.end()); }));
+    print_row("std::sort (sorted)", measure(perf, [&]
+                                            { std::sort(to_sort.begin(), to_sort.end()); }));
+
+    // vector growth: push_back reallocates ~log2(n) times and copies everything
+    std::size_t final_capacity = 0;
+    print_row("push_back, no reserve", measure(perf, [&]
+                                               {
+        std::vector<int> v;
+        for (std::size_t i = 0; i < n; i++) { v.push_back(static_cast<int>(i)); }
+        final_capacity = v.capacity(); }));
+    print_row("push_back, reserve(n)", measure(perf, [&]
+                                               {
+        std::vector<int> v;
+        v.reserve(n);
+        for (std::size_t i = 0; i < n; i++) { v.push_back(static_cast<int>(i)); }
+        final_capacity += v.capacity(); }));
+
+    std::cout << "\n(checksums: sum=" << total << ", capacity=" << final_capacity
+              << ", sorted=" << std::is_sorted(to_sort.begin(), to_sort.end()) << ")\n";
+    return 0;
+}
+
+/*
+----------------------------------------------------------------------
+KEY TAKEAWAYS:
+----------------------------------------------------------------------
+1. perf_event_open gives one file descriptor per counter:
+   RESET → ENABLE → code → DISABLE → read().
+
+2. IPC (instructions per cycle) is the first number to look at:
+   ~3-4 = the CPU is busy computing, < 1 = it is mostly waiting
+   (cache misses, branch mispredictions).
+
+3. Compare sorting random vs already-sorted data: same instructions
+   roughly, very different branch-miss counts.
+
+4. Always degrade gracefully: counters may be forbidden
+   (perf_event_paranoid) or missing (VMs). Use std::optional for
+   "no value" instead of printing a bogus 0.
+
+5. If more counters are requested than the CPU has, the kernel
+   multiplexes them; scale by time_enabled / time_running. Open them as
+   ONE group (PERF_FORMAT_GROUP, PERF_IOC_FLAG_GROUP) so every counter
+   covers the same time window and ratios like IPC stay honest.
+
+- How to Run:
+    g++ 50perf_counters.cpp -o perfc --std=c++20 -O2
+    ./perfc 20000000   // optional element count
+----------------------------------------------------------------------
+*/
@@ -0,0 +1,416 @@
+#include <iostream>    // For std::cout
+#include <iomanip>     // For std::setw
+#include <array>       // For field tables
+#include <vector>      // For arrays of records
+#include <tuple>       // For std::tuple_element_t
+#include <cstddef>     // For offsetof, std::byte
+#include <cstdint>     // For fixed-width fields
+#include <cstring>     // For std::memcpy
+#include <cassert>     // For range checks in BitPacked::set
+#include <type_traits> // For std::is_trivially_copyable_v
+#include <random>      // For test data
+#include <chrono>      // For timing
+
+/*
+----------------------------------------------------------------------
+TOPIC: STRUCT LAYOUT, PADDING AND PACKING
+----------------------------------------------------------------------
+26structs.cpp says sizeof(Point) is "≈ 8 bytes (may be slightly more due
+to padding)", 28struct_constructors.cpp says "no padding because both
+members are int". With mixed types, padding is not slight:
+
+    struct Trade
+    {
+        char flag;     // 1 byte  + 7 padding (price must start at a multiple of 8)
+        double price;  // 8
+        int16_t qty;   // 2       + 2 padding
+        int32_t id;    // 4
+        char type;     // 1       + 7 padding
+        int64_t ts;    // 8
+        bool active;   // 1       + 7 padding (sizeof must be a multiple of 8)
+    };                 // 25 bytes of data, sizeof = 48
+
+Almost half the bytes are padding, so half of every cache line we load
+is wasted.
+
+Three tools in this file:
+1. A layout REPORT (offset, size, padding per field) built at compile time
+   from a short field list, plus static_assert budgets such as
+   "at most 8 bytes of padding".
+2. Reordered<Ts...>: the same fields, automatically placed largest
+   alignment first → minimal padding. Fields keep their original index.
+3. BitPacked<Widths...>: small-range fields stored in just the bits they
+   need (a 0/1 flag takes 1 bit, not 1 byte + padding).
+----------------------------------------------------------------------
+*/
+
+// ------------------------ 1. LAYOUT REPORT -----------------------------
+
+struct FieldInfo
+{
+    const char *name;
+    std::size_t offset;
+    std::size_t size;
+};
+
+// One table entry per field; offsetof works at compile time for standard-layout types
+#define LAYOUT_FIELD(S, f) FieldInfo{#f, offsetof(S, f), sizeof(S::f)}
+
+template <std::size_t N>
+struct Layout
+{
+    const char *name;
+    std::size_t size;
+    std::array<FieldInfo, N> fields; // in declaration order
+
+    constexpr std::size_t data_bytes() const
+    {
+        std::size_t total = 0;
+        for (const auto &f : fields)
+        {
+            total += f.size;
+        }
+        return total;
+    }
+
+    constexpr std::size_t padding_bytes() const { return size - data_bytes(); }
+
+    // Padding right after field i (up to the next field, or the end of the struct)
+    constexpr std::size_t padding_after(std::size_t i) const
+    {
+        std::size_t end = fields[i].offset + fields[i].size;
+        std::size_t next = size;
+        for (const auto &f : fields)
+        {
+            if (f.offset >= end && f.offset < next)
+            {
+                next = f.offset;
+            }
+        }
+        return next - end;
+    }
+
+    void print() const
+    {
+        std::cout << name << ": sizeof = " << size << ", data = " << data_bytes()
+                  << ", padding = " << padding_bytes() << " ("
+                  << 100 * padding_bytes() / size << "%)\n";
+        for (std::size_t i = 0; i < N; i++)
+        {
+            std::cout << "  " << std::left << std::setw(8) << fields[i].name << std::right
+                      << " offset " << std::setw(2) << fields[i].offset << "  size " << fields[i].size;
+            if (padding_after(i))
+            {
+                std::cout << "  + " << padding_after(i) << " padding";
+            }
+            std::cout << '\n';
+        }
+    }
+};
+
+template <typename S, std::size_t N>
+constexpr Layout<N> describe(const char *name, const FieldInfo (&fields)[N])
+{
+    Layout<N> layout{name, sizeof(S), {}};
+    for (std::size_t i = 0; i < N; i++)
+    {
+        layout.fields[i] = fields[i];
+    }
+    return layout;
+}
+
+// ------------------------ 2. AUTOMATIC REORDERING -----------------------------
+
+constexpr std::size_t align_up(std::size_t n, std::size_t a)
+{
+    return (n + a - 1) / a * a;
+}
+
+/*
+Stores Ts... sorted by alignment (largest first), which never needs
+padding between fields. get<I>() / set<I>() still use the ORIGINAL order,
+so swapping a struct for Reordered doesn't reshuffle the callers.
+Fields are accessed with memcpy: well-defined for trivially copyable
+types, and compiles to a single load/store.
+*/
+template <typename... Ts>
+class Reordered
+{
+    static_assert((std::is_trivially_copyable_v<Ts> && ...), "fields must be trivially copyable");
+
+    static constexpr std::size_t N = sizeof...(Ts);
+    static constexpr std::array<std::size_t, N> kSizes{sizeof(Ts)...};
+    static constexpr std::array<std::size_t, N> kAligns{alignof(Ts)...};
+
+    static constexpr std::array<std::size_t, N> compute_offsets()
+    {
+        std::array<std::size_t, N> order{};
+        for (std::size_t i = 0; i < N; i++)
+        {
+            order[i] = i;
+        }
+        // insertion sort by descending alignment (stable: ties keep declaration order)
+        for (std::size_t i = 1; i < N; i++)
+        {
+            for (std::size_t j = i; j > 0 && kAligns[order[j - 1]] < kAligns[order[j]]; j--)
+            {
+                std::swap(order[j - 1], order[j]);
+            }
+        }
+        std::array<std::size_t, N> offsets{};
+        std::size_t offset = 0;
+        for (std::size_t idx : order)
+        {
+            offset = align_up(offset, kAligns[idx]);
+            offsets[idx] = offset;
+            offset += kSizes[idx];
+        }
+        return offsets;
+    }
+
+    static constexpr std::size_t max_align()
+    {
+        std::size_t a = 1;
+        for (std::size_t x : kAligns)
+        {
+            a = x > a ? x : a;
+        }
+        return a;
+    }
+
+public:
+    static constexpr std::array<std::size_t, N> kOffsets = compute_offsets();
+    static constexpr std::size_t kAlign = max_align();
+    static constexpr std::size_t kDataBytes = (sizeof(Ts) + ...);
+
+    template <std::size_t I>
+    using type = std::tuple_element_t<I, std::tuple<Ts...>>;
+
+    Reordered() = default;
+
+    explicit Reordered(const Ts &...values)
+    {
+        set_all(std::index_sequence_for<Ts...>{}, values...);
+    }
+
+    template <std::size_t I>
+    type<I> get() const
+    {
+        type<I> value;
+        std::memcpy(&value, data_ + kOffsets[I], sizeof(value));
+        return value;
+    }
+
+    template <std::size_t I>
+    void set(const type<I> &value)
+    {
+        std::memcpy(data_ + kOffsets[I], &value, sizeof(value));
+    }
+
+private:
+    template <std::size_t... Is>
+    void set_all(std::index_sequence<Is...>, const Ts &...values)
+    {
+        (set<Is>(values), ...);
+    }
+
+    alignas(kAlign) std::byte data_[align_up(kDataBytes, kAlign)]{};
+};
+
+// ------------------------ 3. BIT PACKING -----------------------------
+
+/*
+Each field gets exactly Widths[i] bits inside one unsigned word (the
+smallest of uint8/16/32/64 that fits). Values are unsigned, 0..2^w - 1.
+*/
+template <unsigned... Widths>
+class BitPacked
+{
+    static constexpr std::size_t N = sizeof...(Widths);
+    static constexpr unsigned kTotalBits = (Widths + ...);
+    static_assert(kTotalBits <= 64, "BitPacked fields must fit in 64 bits");
+
+    static constexpr std::array<unsigned, N> kWidths{Widths...};
+    static constexpr std::array<unsigned, N> kShifts = []
+    {
+        std::array<unsigned, N> shifts{};
+        unsigned shift = 0;
+        for (std::size_t i = 0; i < N; i++)
+        {
+            shifts[i] = shift;
+            shift += kWidths[i];
+        }
+        return shifts;
+    }();
+
+    template <std::size_t I>
+    static constexpr uint64_t mask()
+    {
+        return kWidths[I] == 64 ? ~uint64_t{0} : (uint64_t{1} << kWidths[I]) - 1;
+    }
+
+public:
+    using Word = std::conditional_t<kTotalBits <= 8, uint8_t,
+                                    std::conditional_t<kTotalBits <= 16, uint16_t,
+                                                       std::conditional_t<kTotalBits <= 32, uint32_t, uint64_t>>>;
+
+    template <std::size_t I>
+    uint64_t get() const
+    {
+        return (static_cast<uint64_t>(bits_) >> kShifts[I]) & mask<I>();
+    }
+
+    template <std::size_t I>
+    void set(uint64_t value)
+    {
+        assert(value <= mask<I>() && "value does not fit in its bit field");
+        uint64_t cleared = static_cast<uint64_t>(bits_) & ~(mask<I>() << kShifts[I]);
+        bits_ = static_cast<Word>(cleared | ((value & mask<I>()) << kShifts[I]));
+    }
+
+private:
+    Word bits_ = 0;
+};
+
+// ------------------------ EXAMPLE RECORDS -----------------------------
+
+struct Trade
+{
+    char flag;    // 0/1
+    double price;
+    int16_t qty;  // 0..4095
+    int32_t id;
+    char type;    // 0..7
+    int64_t ts;
+    bool active;
+};
+
+constexpr auto kTradeLayout = describe<Trade>("Trade", {
+                                                           LAYOUT_FIELD(Trade, flag),
+                                                           LAYOUT_FIELD(Trade, price),
+                                                           LAYOUT_FIELD(Trade, qty),
+                                                           LAYOUT_FIELD(Trade, id),
+                                                           LAYOUT_FIELD(Trade, type),
+                                                           LAYOUT_FIELD(Trade, ts),
+                                                           LAYOUT_FIELD(Trade, active),
+                                                       });
+
+// Budgets: this one documents the problem, so it is a loose upper bound...
+static_assert(kTradeLayout.padding_bytes() <= 24, "Trade padding grew beyond budget");
+// ...a tighter budget, e.g. <= 8, would fail to compile with the field order above.
+
+// Same fields, same index order, minimal padding
+using PackedTrade = Reordered<char, double, int16_t, int32_t, char, int64_t, bool>;
+static_assert(sizeof(PackedTrade) == 32, "25 data bytes rounded up to alignment 8");
+static_assert(sizeof(PackedTrade) - PackedTrade::kDataBytes <= 7, "padding only at the end");
+
+// Small-range fields in 17 bits: flag (1) | qty (12) | type (3) | active (1)
+using TradeBits = BitPacked<1, 12, 3, 1>;
+static_assert(sizeof(TradeBits) == 4);
+
+struct BitTrade
+{
+    double price;
+    int64_t ts;
+    int32_t id;
+    TradeBits bits;
+};
+static_assert(sizeof(BitTrade) == 24, "three trades fit in 72 bytes instead of 144");
+
+// ------------------------ BENCHMARK -----------------------------
+
+template <typename F>
+double time_ms(F &&f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+int main(int argc, char **argv)
+{
+    std::size_t n = argc > 1 ? std::stoull(argv[1]) : 10'000'000;
+
+    kTradeLayout.print();
+    std::cout << "\nPackedTrade: sizeof = " << sizeof(PackedTrade) << ", offsets (declaration order):";
+    for (std::size_t off : PackedTrade::kOffsets)
+    {
+        std::cout << ' ' << off;
+    }
+    std::cout << "\nBitTrade:    sizeof = " << sizeof(BitTrade) << " (flag/qty/type/active in "
+              << sizeof(TradeBits) << " bytes)\n\n";
+
+    // Same random trades in all three layouts
+    std::vector<Trade> plain(n);
+    std::vector<PackedTrade> packed(n);
+    std::vector<BitTrade> bitpacked(n);
+    std::mt19937 rng(42);
+    for (std::size_t i = 0; i < n; i++)
+    {
+        Trade t{static_cast<char>(rng() & 1), (rng() % 10000) / 100.0, static_cast<int16_t>(rng() % 4096),
+                static_cast<int32_t>(i), static_cast<char>(rng() % 8), static_cast<int64_t>(i) * 1000, (rng() & 3) != 0};
+        plain[i] = t;
+        packed[i] = PackedTrade(t.flag, t.price, t.qty, t.id, t.type, t.ts, t.active);
+        bitpacked[i].price = t.price;
+        bitpacked[i].ts = t.ts;
+        bitpacked[i].id = t.id;
+        bitpacked[i].bits.set<0>(static_cast<uint64_t>(t.flag));
+        bitpacked[i].bits.set<1>(static_cast<uint64_t>(t.qty));
+        bitpacked[i].bits.set<2>(static_cast<uint64_t>(t.type));
+        bitpacked[i].bits.set<3>(t.active);
+    }
+
+    // Query: total notional (price * qty) of active trades
+    double a = 0, b = 0, c = 0;
+    double t_plain = time_ms([&]
+                             {
+        for (const Trade &t : plain)
+        {
+            a += t.active ? t.price * t.qty : 0.0;
+        } });
+    double t_packed = time_ms([&]
+                              {
+        for (const PackedTrade &t : packed)
+        {
+            b += t.get<6>() ? t.get<1>() * t.get<2>() : 0.0;
+        } });
+    double t_bits = time_ms([&]
+                            {
+        for (const BitTrade &t : bitpacked)
+        {
+            c += t.bits.get<3>() ? t.price * static_cast<double>(t.bits.get<1>()) : 0.0;
+        } });
+
+    std::cout << "Scan " << n / 1'000'000 << "M trades (active notional):\n"
+              << "  Trade       " << std::setw(4) << n * sizeof(Trade) / (1 << 20) << " MB  " << t_plain << " ms\n"
+              << "  PackedTrade " << std::setw(4) << n * sizeof(PackedTrade) / (1 << 20) << " MB  " << t_packed << " ms\n"
+              << "  BitTrade    " << std::setw(4) << n * sizeof(BitTrade) / (1 << 20) << " MB  " << t_bits << " ms\n"
+              << (a == b && b == c ? "  (all three agree)\n" : "  MISMATCH\n");
+    return 0;
+}
+
+/*
+----------------------------------------------------------------------
+KEY TAKEAWAYS:
+----------------------------------------------------------------------
+1. Every field starts at a multiple of its alignment, and sizeof is a
+   multiple of the largest alignment. Mixed char/int/double fields in
+   declaration order can waste close to half the struct.
+
+2. offsetof + sizeof are compile-time constants, so a layout report and
+   static_assert budgets cost nothing at run time and catch regressions
+   when someone adds a field in the wrong place.
+
+3. Sorting fields by alignment (largest first) gives minimal padding.
+   Reordered<Ts...> does it automatically and keeps the original indices.
+
+4. Small-range fields (flags, enums, small counts) fit in a few bits.
+   BitPacked trades a shift + mask on access for much smaller records.
+
+5. Smaller records → more records per 64-byte cache line → faster scans.
+
+- How to Run:
+    g++ 51struct_layout.cpp -o layout --std=c++20 -O2
+----------------------------------------------------------------------
+*/
@@ -0,0 +1,237 @@
+#include <iostream>   // For std::cout
+#include <iomanip>    // For std::setw
+#include <vector>     // For slots and threads
+#include <memory>     // For std::unique_ptr (see 22unique_ptr_part1.cpp)
+#include <atomic>     // For shared and sharded counters
+#include <thread>     // For std::thread, hardware_concurrency
+#include <new>        // For std::hardware_destructive_interference_size
+#include <functional> // For std::plus
+#include <chrono>     // For timing
+
+/*
+----------------------------------------------------------------------
+TOPIC: PER-THREAD ACCUMULATORS AND FALSE SHARING
+----------------------------------------------------------------------
+sum_array (11functions.cpp) and add_vector_pass_by_ref (19pass_by_ref.cpp)
+add everything into ONE variable. Split that loop across threads and the
+obvious fix, std::atomic<long> total, becomes the bottleneck: every
+fetch_add needs exclusive ownership of total's cache line, so the line
+bounces between cores.
+
+"Give each thread its own counter in an array" isn't enough either:
+
+    std::atomic<long> counts[8]; // 8 * 8 bytes = all in ONE 64-byte line
+
+Different variables, same cache line → the line still bounces. That's
+FALSE SHARING: no data is actually shared, but the hardware moves whole
+cache lines.
+
+Fix: give every slot its own cache line,
+
+    struct alignas(std::hardware_destructive_interference_size) Slot { T value; };
+
+and combine the slots only when someone READS the total (rare), instead
+of on every write (hot).
+
+Two primitives below:
+- per_thread<T>: one padded slot per worker index, any T (not atomic,
+  each slot has exactly one writer). combine() folds them.
+- ShardedCounter: a counter any thread can add() to. Threads are spread
+  over padded atomic shards; read() sums the shards.
+----------------------------------------------------------------------
+*/
+
+#ifdef __cpp_lib_hardware_interference_size
+constexpr std::size_t kNoFalseSharing = std::hardware_destructive_interference_size;
+#else
+constexpr std::size_t kNoFalseSharing = 64; // typical x86/ARM cache line
+#endif
+
+// ------------------------ per_thread<T> -----------------------------
+
+template <typename T>
+class per_thread
+{
+public:
+    explicit per_thread(std::size_t workers, const T &init = T{})
+        : size_(workers), slots_(std::make_unique<Slot[]>(workers))
+    {
+        for (std::size_t i = 0; i < size_; i++)
+        {
+            slots_[i].value = init;
+        }
+    }
+
+    // Each worker index must be used by exactly one thread at a time
+    T &local(std::size_t worker) { return slots_[worker].value; }
+
+    template <typename Op>
+    T combine(T init, Op op) const
+    {
+        for (std::size_t i = 0; i < size_; i++)
+        {
+            init = op(init, slots_[i].value);
+        }
+        return init;
+    }
+
+    std::size_t size() const { return size_; }
+
+private:
+    struct alignas(kNoFalseSharing) Slot
+    {
+        T value;
+    };
+    static_assert(sizeof(Slot) % kNoFalseSharing == 0, "each slot fills whole cache lines");
+
+    std::size_t size_;
+    std::unique_ptr<Slot[]> slots_;
+};
+
+// ------------------------ ShardedCounter -----------------------------
+
+class ShardedCounter
+{
+public:
+    explicit ShardedCounter(std::size_t shards = std::thread::hardware_concurrency())
+        : size_(shards ? shards : 1), shards_(std::make_unique<Shard[]>(size_)) {}
+
+    void add(long n)
+    {
+        // relaxed: we only need the final total to be right, not ordering
+        shards_[my_shard() % size_].value.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    long read() const
+    {
+        long total = 0;
+        for (std::size_t i = 0; i < size_; i++)
+        {
+            total += shards_[i].value.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+private:
+    struct alignas(kNoFalseSharing) Shard
+    {
+        std::atomic<long> value{0};
+    };
+
+    // Every thread gets a fixed index the first time it calls add()
+    static std::size_t my_shard()
+    {
+        static std::atomic<std::size_t> next{0};
+        thread_local std::size_t index = next.fetch_add(1, std::memory_order_relaxed);
+        return index;
+    }
+
+    std::size_t size_;
+    std::unique_ptr<Shard[]> shards_;
+};
+
+// ------------------------ BENCHMARK -----------------------------
+
+template <typename Work>
+double run_threads_ms(std::size_t threads, Work work)
+{
+    std::vector<std::thread> pool;
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t t = 0; t < threads; t++)
+    {
+        pool.emplace_back(work, t);
+    }
+    for (auto &th : pool)
+    {
+        th.join();
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+int main(int argc, char **argv)
+{
+    long iters = argc > 1 ? std::stol(argv[1]) : 1'000'000; // per thread
+    std::size_t cores = std::thread::hardware_concurrency();
+
+    std::cout << "sizeof padded slot = " << kNoFalseSharing << " bytes, cores = " << cores
+              << ", " << iters << " adds per thread\n";
+    std::cout << "Throughput in million adds/s (higher is better):\n\n";
+    std::cout << "threads  shared-atomic  adjacent-atomics  sharded  per_thread\n";
+
+    for (std::size_t threads : {1, 2, 4, 8, 16, 32, 64})
+    {
+        double total_adds = static_cast<double>(iters) * static_cast<double>(threads);
+        bool ok = true;
+
+        // 1. One shared atomic: every add fights for the same line
+        std::atomic<long> shared{0};
+        double t_shared = run_threads_ms(threads, [&](std::size_t)
+                                         {
+            for (long i = 0; i < iters; i++) { shared.fetch_add(1, std::memory_order_relaxed); } });
+        ok &= shared.load() == static_cast<long>(total_adds);
+
+        // 2. One atomic per thread, but packed next to each other: false sharing
+        std::vector<std::atomic<long>> adjacent(threads);
+        double t_adjacent = run_threads_ms(threads, [&](std::size_t t)
+                                           {
+            for (long i = 0; i < iters; i++) { adjacent[t].fetch_add(1, std::memory_order_relaxed); } });
+        long adjacent_total = 0;
+        for (auto &a : adjacent)
+        {
+            adjacent_total += a.load();
+        }
+        ok &= adjacent_total == static_cast<long>(total_adds);
+
+        // 3. ShardedCounter: padded atomic shards
+        ShardedCounter sharded(threads);
+        double t_sharded = run_threads_ms(threads, [&](std::size_t)
+                                          {
+            for (long i = 0; i < iters; i++) { sharded.add(1); } });
+        ok &= sharded.read() == static_cast<long>(total_adds);
+
+        // 4. per_thread<long>: padded plain longs, like sum_array's local `sum`
+        per_thread<long> sums(threads, 0);
+        double t_local = run_threads_ms(threads, [&](std::size_t t)
+                                        {
+            long &mine = sums.local(t);
+            for (long i = 0; i < iters; i++) { mine += i & 1; } // may stay in a register: nobody else touches it
+        });
+        ok &= sums.combine(0L, std::plus<long>{}) == static_cast<long>(threads) * (iters / 2);
+
+        auto rate = [&](double ms)
+        { return total_adds / ms / 1000.0; };
+        std::cout << std::setw(7) << threads << std::setw(15) << rate(t_shared) << std::setw(18) << rate(t_adjacent)
+                  << std::setw(9) << rate(t_sharded) << std::setw(12) << rate(t_local)
+                  << (ok ? "" : "  MISMATCH") << '\n';
+    }
+    if (cores <= 1)
+    {
+        std::cout << "\n(only 1 core: threads take turns, so no column can scale here;\n"
+                     " run on a multi-core machine to see the shared atomic flatten out)\n";
+    }
+    return 0;
+}
+
+/*
+----------------------------------------------------------------------
+KEY TAKEAWAYS:
+----------------------------------------------------------------------
+1. Threads that write to the same cache line serialize, even when they
+   write different variables (false sharing).
+
+2. alignas(std::hardware_destructive_interference_size) gives each slot
+   its own cache line. Costs 64 bytes per slot, worth it for hot counters.
+
+3. Write locally, combine on read: writes are frequent, reads of the
+   total are rare, so put the cost on the read side.
+
+4. per_thread<T> works for any T (sums, min/max, histograms) as long as
+   each worker index has one writer. ShardedCounter is for code that
+   can't pass a worker index around.
+
+- How to Run:
+    g++ 52per_thread_counters.cpp -o counters --std=c++20 -O2 -pthread
+    ./counters 5000000   // optional adds per thread
+----------------------------------------------------------------------
+*/
@@ -0,0 +1,482 @@
+#include <iostream>    // For std::cout
+#include <vector>      // For the eager comparison (see 19pass_by_ref.cpp)
+#include <span>        // For chunks and span sources (see 24std_span.cpp)
+#include <array>       // For the fixed-size chunk buffers
+#include <thread>      // For the parallel terminal
+#include <atomic>      // For the allocation counter
+#include <algorithm>   // For std::min
+#include <numeric>     // For std::accumulate
+#include <functional>  // For std::plus
+#include <type_traits> // For std::invoke_result_t
+#include <new>         // For replacing operator new
+#include <cstdlib>     // For std::malloc, std::free
+#include <cstdint>     // For int64_t
+#include <climits>     // For INT_MIN, INT_MAX
+#include <chrono>      // For timing
+
+/*
+----------------------------------------------------------------------
+TOPIC: LAZY VIEWS (pipelines that never build intermediate vectors)
+----------------------------------------------------------------------
+add_vector_pass_by_ref in 19pass_by_ref.cpp builds 0..N-1 with push_back,
+and then we'd loop over it again to sum it. The vector only exists to
+carry numbers from one loop to the next: N * 4 bytes written to memory,
+then read back.
+
+A LAZY pipeline describes the work first and runs it once at the end:
+
+    lazy::iota(0, n) | lazy::transform(f) | lazy::filter(p) | lazy::reduce(0, plus)
+
+- iota, transform, filter, take just build a small object that remembers
+  "what to do". Nothing runs yet, nothing is allocated.
+- The terminal (reduce) drives everything: ONE loop, values flow through
+  every stage while they're still in registers / L1.
+
+Chunks: instead of pushing values one by one, each stage hands the next
+a std::span of up to 256 values living in a small stack buffer. Each
+stage is then a plain loop over a short array, which the compiler can
+vectorize (iota fill, transform, branchless filter, the reduction).
+
+Parallel: iota and span sources can be split into parts; parallel_reduce
+runs the same pipeline on each part in its own thread and combines.
+----------------------------------------------------------------------
+*/
+
+// ------------------------ ALLOCATION COUNTER -----------------------------
+
+// Every heap allocation in this program goes through here, so we can prove
+// the lazy pipeline allocates nothing
+static std::atomic<std::size_t> g_allocations{0};
+
+void *operator new(std::size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *p = std::malloc(size ? size : 1))
+    {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+namespace lazy
+{
+    inline constexpr std::size_t kChunk = 256;
+
+    // ------------------------ SOURCES -----------------------------
+
+    template <typename T>
+    struct IotaView
+    {
+        using value_type = T;
+        T first, last;
+
+        // sink(std::span<const T>) returns false to stop early (take)
+        template <typename Sink>
+        bool run(Sink &&sink) const
+        {
+            alignas(64) std::array<T, kChunk> buf;
+            for (T i = first; i < last;)
+            {
+                std::size_t n = static_cast<std::size_t>(std::min<uint64_t>(kChunk, distance(i, last)));
+                for (std::size_t j = 0; j < n; j++)
+                {
+                    buf[j] = i + static_cast<T>(j);
+                }
+                if (!sink(std::span<const T>(buf.data(), n)))
+                {
+                    return false;
+                }
+                i += static_cast<T>(n);
+            }
+            return true;
+        }
+
+        // Part `k` of `parts`, for parallel terminals
+        IotaView split(std::size_t k, std::size_t parts) const
+        {
+            if (last <= first)
+            {
+                return {first, first};
+            }
+            return {at(k, parts), at(k + 1, parts)};
+        }
+
+    private:
+        // b - a for a <= b, done in uint64_t: iota(INT_MIN, INT_MAX) overflows T
+        static uint64_t distance(T a, T b) { return static_cast<uint64_t>(b) - static_cast<uint64_t>(a); }
+
+        // first + len * k / parts, without ever forming len * k
+        T at(std::size_t k, std::size_t parts) const
+        {
+            uint64_t len = distance(first, last), p = parts;
+            uint64_t offset = len / p * k + len % p * k / p;
+            return static_cast<T>(static_cast<uint64_t>(first) + offset); // modular, back in range
+        }
+    };
+
+    template <typename T>
+    IotaView<T> iota(T first, T last) { return {first, last}; }
+
+    template <typename T>
+    struct SpanView
+    {
+        using value_type = T;
+        std::span<const T> data;
+
+        template <typename Sink>
+        bool run(Sink &&sink) const
+        {
+            for (std::size_t i = 0; i < data.size(); i += kChunk) // no copy: chunks point into data
+            {
+                if (!sink(data.subspan(i, std::min(kChunk, data.size() - i))))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        SpanView split(std::size_t k, std::size_t parts) const
+        {
+            std::size_t b = data.size() * k / parts, e = data.size() * (k + 1) / parts;
+            return {data.subspan(b, e - b)};
+        }
+    };
+
+    template <typename T>
+    SpanView<T> from(std::span<const T> data) { return {data}; }
+
+    // ------------------------ ADAPTORS -----------------------------
+
+    template <typename Src, typename F>
+    struct TransformView
+    {
+        using value_type = std::invoke_result_t<const F &, typename Src::value_type>;
+        Src src;
+        F f;
+
+        template <typename Sink>
+        bool run(Sink &&sink) const
+        {
+            return src.run([&](auto in)
+                           {
+                alignas(64) std::array<value_type, kChunk> out;
+                for (std::size_t j = 0; j < in.size(); j++)
+                {
+                    out[j] = f(in[j]);
+                }
+                return sink(std::span<const value_type>(out.data(), in.size())); });
+        }
+
+        TransformView split(std::size_t k, std::size_t parts) const { return {src.split(k, parts), f}; }
+    };
+
+    template <typename Src, typename P>
+    struct FilterView
+    {
+        using value_type = typename Src::value_type;
+        Src src;
+        P pred;
+
+        template <typename Sink>
+        bool run(Sink &&sink) const
+        {
+            return src.run([&](auto in)
+                           {
+                alignas(64) std::array<value_type, kChunk> out;
+                std::size_t k = 0;
+                for (std::size_t j = 0; j < in.size(); j++) // branchless compaction (see 47stream_compaction.cpp)
+                {
+                    out[k] = in[j];
+                    k += static_cast<std::size_t>(pred(in[j]));
+                }
+                return k == 0 || sink(std::span<const value_type>(out.data(), k)); });
+        }
+
+        FilterView split(std::size_t k, std::size_t parts) const { return {src.split(k, parts), pred}; }
+    };
+
+    // No split(): "first n" depends on everything before it, so take stays sequential
+    template <typename Src>
+    struct TakeView
+    {
+        using value_type = typename Src::value_type;
+        Src src;
+        std::size_t n;
+
+        template <typename Sink>
+        bool run(Sink &&sink) const
+        {
+            std::size_t remaining = n;
+            if (remaining == 0)
+            {
+                return false;
+            }
+            src.run([&](auto in)
+                    {
+                if (in.size() >= remaining)
+                {
+                    sink(in.first(remaining));
+                    return false; // stops the source: nothing after this is computed
+                }
+                remaining -= in.size();
+                return sink(in); });
+            return remaining != 0;
+        }
+    };
+
+    // "Half-built" adaptors: know what to do, not yet what to do it to
+    template <typename F>
+    struct Transform
+    {
+        F f;
+        template <typename Src>
+        auto apply(Src src) const { return TransformView<Src, F>{std::move(src), f}; }
+    };
+
+    template <typename P>
+    struct Filter
+    {
+        P pred;
+        template <typename Src>
+        auto apply(Src src) const { return FilterView<Src, P>{std::move(src), pred}; }
+    };
+
+    struct Take
+    {
+        std::size_t n;
+        template <typename Src>
+        auto apply(Src src) const { return TakeView<Src>{std::move(src), n}; }
+    };
+
+    template <typename F>
+    Transform<F> transform(F f) { return {std::move(f)}; }
+
+    template <typename P>
+    Filter<P> filter(P pred) { return {std::move(pred)}; }
+
+    inline Take take(std::size_t n) { return {n}; }
+
+    // ------------------------ TERMINALS -----------------------------
+
+    template <typename T, typename Op>
+    struct Reduce
+    {
+        T init;
+        Op op;
+
+        template <typename Src>
+        T apply(const Src &src) const
+        {
+            T acc = init;
+            src.run([&](auto in)
+                    {
+                if (in.size() == kChunk)
+                {
+                    for (std::size_t j = 0; j < kChunk; j++) // constant trip count: vectorizes at -O2
+                    {
+                        acc = op(acc, static_cast<T>(in[j]));
+                    }
+                }
+                else
+                {
+                    for (std::size_t j = 0; j < in.size(); j++)
+                    {
+                        acc = op(acc, static_cast<T>(in[j]));
+                    }
+                }
+                return true; });
+            return acc;
+        }
+    };
+
+    template <typename T, typename Op>
+    Reduce<T, Op> reduce(T init, Op op) { return {init, std::move(op)}; }
+
+    /*
+    Runs the pipeline on `threads` parts at once. `init` must be the
+    identity of `op` (0 for +, 1 for *), because every part starts from it.
+    */
+    template <typename T, typename Op>
+    struct ParallelReduce
+    {
+        T init;
+        Op op;
+        unsigned threads;
+
+        template <typename Src>
+        T apply(const Src &src) const
+        {
+            std::vector<T> partial(threads, init);
+            std::vector<std::thread> pool;
+            for (unsigned t = 0; t < threads; t++)
+            {
+                pool.emplace_back([&, t]
+                                  { partial[t] = Reduce<T, Op>{init, op}.apply(src.split(t, threads)); });
+            }
+            for (auto &th : pool)
+            {
+                th.join();
+            }
+            T acc = init;
+            for (const T &p : partial)
+            {
+                acc = op(acc, p);
+            }
+            return acc;
+        }
+    };
+
+    template <typename T, typename Op>
+    ParallelReduce<T, Op> parallel_reduce(T init, Op op, unsigned threads = std::thread::hardware_concurrency())
+    {
+        return {init, std::move(op), threads ? threads : 1};
+    }
+
+    struct ToVector
+    {
+        template <typename Src>
+        auto apply(const Src &src) const
+        {
+            std::vector<typename Src::value_type> out;
+            src.run([&](auto in)
+                    {
+                out.insert(out.end(), in.begin(), in.end());
+                return true; });
+            return out;
+        }
+    };
+
+    inline ToVector to_vector() { return {}; }
+
+    // view | adaptor → bigger view, view | terminal → result
+    template <typename Src, typename Stage>
+        requires requires(Src s, Stage st) { typename Src::value_type; st.apply(s); }
+    auto operator|(Src src, const Stage &stage)
+    {
+        return stage.apply(std::move(src));
+    }
+} // namespace lazy
+
+// ------------------------ BENCHMARK -----------------------------
+
+template <typename F>
+double time_ms(F &&f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+int main(int argc, char **argv)
+{
+    int64_t n = argc > 1 ? std::stoll(argv[1]) : 100'000'000;
+
+    // 0. Small example
+    auto first_squares = lazy::iota(1, 100) | lazy::transform([](int x)
+                                                               { return x * x; }) |
+                         lazy::filter([](int x)
+                                      { return x % 3 == 1; }) |
+                         lazy::take(5) | lazy::to_vector();
+    std::cout << "First 5 squares ≡ 1 (mod 3):";
+    for (int x : first_squares)
+    {
+        std::cout << ' ' << x;
+    }
+    std::cout << '\n';
+
+    // Splitting the whole int range must not overflow int: parts stay contiguous
+    auto everything = lazy::iota(INT_MIN, INT_MAX);
+    int64_t covered = 0;
+    bool contiguous = true;
+    for (std::size_t k = 0; k < 7; k++)
+    {
+        auto part = everything.split(k, 7);
+        contiguous &= part.first == (k == 0 ? INT_MIN : everything.split(k - 1, 7).last);
+        covered += int64_t{part.last} - part.first;
+    }
+    std::cout << "iota(INT_MIN, INT_MAX) split 7 ways covers " << covered << " values"
+              << (contiguous && covered == int64_t{INT_MAX} - INT_MIN ? "" : "  MISMATCH") << "\n\n";
+
+    // 1. 0..N-1 then sum: eager (like add_vector_pass_by_ref) vs lazy
+    int64_t eager = 0, lazy_sum = 0;
+    std::size_t allocs_before = g_allocations.load();
+    double t_eager = time_ms([&]
+                             {
+        std::vector<int64_t> v;
+        for (int64_t i = 0; i < n; i++) { v.push_back(i); }
+        eager = std::accumulate(v.begin(), v.end(), int64_t{0}); });
+    std::size_t eager_allocs = g_allocations.load() - allocs_before;
+
+    allocs_before = g_allocations.load();
+    double t_lazy = time_ms([&]
+                            { lazy_sum = lazy::iota(int64_t{0}, n) | lazy::reduce(int64_t{0}, std::plus<>{}); });
+    std::size_t lazy_allocs = g_allocations.load() - allocs_before;
+
+    std::cout << "Sum of 0.." << n - 1 << ":\n"
+              << "  push_back + accumulate: " << t_eager << " ms, " << eager_allocs << " allocations\n"
+              << "  iota | reduce:          " << t_lazy << " ms, " << lazy_allocs << " allocations"
+              << (eager == lazy_sum ? "" : "  MISMATCH") << "\n\n";
+
+    // 2. Longer pipeline: eager version materializes every step
+    auto sq = [](int64_t x)
+    { return x * x % 1000; };
+    auto even = [](int64_t x)
+    { return x % 2 == 0; };
+    int64_t e2 = 0, l2 = 0, p2 = 0;
+    double t_eager2 = time_ms([&]
+                              {
+        std::vector<int64_t> a(static_cast<std::size_t>(n));
+        std::iota(a.begin(), a.end(), int64_t{0});
+        std::vector<int64_t> b;
+        b.reserve(a.size());
+        for (int64_t x : a) { b.push_back(sq(x)); }
+        std::vector<int64_t> c;
+        for (int64_t x : b) { if (even(x)) c.push_back(x); }
+        e2 = std::accumulate(c.begin(), c.end(), int64_t{0}); });
+
+    auto pipeline = lazy::iota(int64_t{0}, n) | lazy::transform(sq) | lazy::filter(even);
+    allocs_before = g_allocations.load();
+    double t_lazy2 = time_ms([&]
+                             { l2 = pipeline | lazy::reduce(int64_t{0}, std::plus<>{}); });
+    lazy_allocs = g_allocations.load() - allocs_before;
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    double t_par2 = time_ms([&]
+                            { p2 = pipeline | lazy::parallel_reduce(int64_t{0}, std::plus<>{}, threads); });
+
+    std::cout << "iota | transform(x*x % 1000) | filter(even) | sum:\n"
+              << "  eager (3 vectors):   " << t_eager2 << " ms\n"
+              << "  lazy:                " << t_lazy2 << " ms, " << lazy_allocs << " allocations\n"
+              << "  lazy, " << threads << " thread(s):  " << t_par2 << " ms"
+              << (e2 == l2 && l2 == p2 ? "" : "  MISMATCH") << '\n';
+    return 0;
+}
+
+/*
+----------------------------------------------------------------------
+KEY TAKEAWAYS:
+----------------------------------------------------------------------
+1. Adaptors (transform, filter, take) only build small objects; the
+   terminal (reduce, to_vector) runs everything in one fused loop.
+
+2. No intermediate containers → no allocations and no extra trips through
+   memory. The operator new counter shows 0 allocations for iota | reduce.
+
+3. Passing 256-value chunks between stages keeps every stage a simple
+   loop over a short array, which the compiler vectorizes.
+
+4. take() stops the source early by returning false up the chain: values
+   after the n-th are never produced.
+
+5. Splittable sources (iota, spans) give parallelism for free: each thread
+   runs the same pipeline on its own part, then partial results combine.
+
+- How to Run:
+    g++ 53lazy_views.cpp -o views --std=c++20 -O2 -pthread
+    ./views 200000000   // optional N
+----------------------------------------------------------------------
+*/
@@ -0,0 +1,458 @@
+#include <iostream>    // For std::cout
+#include <vector>      // For the std::vector baselines (see 17vector.cpp)
+#include <span>        // For append(span) and the fill kernels (see 24std_span.cpp)
+#include <memory>      // For std::uninitialized_* and std::construct_at
+#include <new>         // For aligned operator new
+#include <numeric>     // For std::iota
+#include <algorithm>   // For std::max
+#include <type_traits> // For std::is_trivially_copyable_v
+#include <utility>     // For std::exchange
+#include <cstring>     // For std::memcpy
+#include <cstdint>     // For int32_t, uintptr_t
+#include <chrono>      // For timing
+
+#if defined(__AVX2__)
+#include <immintrin.h> // For 256-bit stores and streaming stores
+#endif
+
+/*
+----------------------------------------------------------------------
+TOPIC: FILLING VECTORS IN BULK
+----------------------------------------------------------------------
+17vector.cpp and add_vector_pass_by_ref (19pass_by_ref.cpp) grow vectors
+with push_back(i) in a loop. Each push_back:
+  1. compares size with capacity,
+  2. if full: allocates 2x, moves everything, frees the old block,
+  3. writes one element and bumps size.
+Step 1 is a branch + a store of `size` per element, and its dependency
+on the previous size stops the compiler from vectorizing the loop.
+Step 2 copies the data ~log2(N) times.
+
+When we know HOW MANY elements are coming, we can do better:
+- append(span):          one capacity check, then one memcpy.
+- append_n(count, gen):  one capacity check, then a plain loop
+                         out[i] = gen(i) the compiler can vectorize.
+- resize_default_init(n): grow WITHOUT writing zeros. std::vector's
+                         resize(n) zero-fills, which for a buffer we're
+                         about to overwrite is a wasted pass over memory.
+
+Finally the fill itself: for arrays much bigger than the cache, AVX2
+"streaming" (non-temporal) stores write straight to memory without first
+reading each cache line in. That makes the fill limited only by memory
+bandwidth.
+----------------------------------------------------------------------
+*/
+
+// ------------------------ BulkVector<T> -----------------------------
+
+/*
+The subset of std::vector used in this repo (push_back, reserve, size,
+capacity, operator[], begin/end), plus the bulk operations above.
+Storage is 64-byte aligned so SIMD kernels can use aligned stores.
+*/
+template <typename T>
+class BulkVector
+{
+public:
+    static constexpr std::size_t kAlign = std::max<std::size_t>(64, alignof(T));
+
+    BulkVector() = default;
+    BulkVector(const BulkVector &) = delete;
+    BulkVector &operator=(const BulkVector &) = delete;
+
+    // Moving just steals the buffer, like std::vector
+    BulkVector(BulkVector &&other) noexcept
+        : data_(std::exchange(other.data_, nullptr)),
+          size_(std::exchange(other.size_, 0)),
+          capacity_(std::exchange(other.capacity_, 0)) {}
+
+    BulkVector &operator=(BulkVector &&other) noexcept
+    {
+        if (this != &other)
+        {
+            std::destroy_n(data_, size_);
+            deallocate(data_);
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+            capacity_ = std::exchange(other.capacity_, 0);
+        }
+        return *this;
+    }
+
+    ~BulkVector()
+    {
+        std::destroy_n(data_, size_);
+        deallocate(data_);
+    }
+
+    std::size_t size() const { return size_; }
+    std::size_t capacity() const { return capacity_; }
+    T *data() { return data_; }
+    const T *data() const { return data_; }
+    T *begin() { return data_; }
+    T *end() { return data_ + size_; }
+    const T *begin() const { return data_; }
+    const T *end() const { return data_ + size_; }
+    T &operator[](std::size_t i) { return data_[i]; }
+    const T &operator[](std::size_t i) const { return data_[i]; }
+
+    void reserve(std::size_t n)
+    {
+        if (n > capacity_)
+        {
+            reallocate(n);
+        }
+    }
+
+    void clear()
+    {
+        std::destroy_n(data_, size_);
+        size_ = 0; // capacity stays: refilling costs no allocation
+    }
+
+    void push_back(const T &value)
+    {
+        append(std::span<const T>(&value, 1)); // `value` may live inside this vector
+    }
+
+    /*
+    Copies `values` to the end: one capacity check, one memcpy for trivial T.
+    `values` may point into this vector (v.append(v)), so when we must grow,
+    the new elements are copied into the NEW buffer before the old one is
+    freed — the same order std::vector::insert uses.
+    */
+    void append(std::span<const T> values)
+    {
+        std::size_t n = values.size();
+        if (size_ + n > capacity_)
+        {
+            std::size_t new_capacity = std::max({size_ + n, 2 * capacity_, std::size_t{16}});
+            T *fresh = allocate(new_capacity);
+            try
+            {
+                std::uninitialized_copy(values.begin(), values.end(), fresh + size_);
+            }
+            catch (...)
+            {
+                deallocate(fresh);
+                throw;
+            }
+            relocate_into(fresh, new_capacity);
+        }
+        else
+        {
+            std::uninitialized_copy(values.begin(), values.end(), data_ + size_);
+        }
+        size_ += n;
+    }
+
+    // Appends gen(0), gen(1), ..., gen(count - 1)
+    template <typename Gen>
+    void append_n(std::size_t count, Gen gen)
+    {
+        grow_for(count);
+        T *out = data_ + size_;
+        for (std::size_t i = 0; i < count; i++) // no capacity check inside: vectorizable
+        {
+            std::construct_at(out + i, gen(i));
+        }
+        size_ += count;
+    }
+
+    // Like resize(n), but new trivial elements are left uninitialized (no zero-fill pass)
+    void resize_default_init(std::size_t n)
+    {
+        if (n > size_)
+        {
+            grow_for(n - size_);
+            std::uninitialized_default_construct_n(data_ + size_, n - size_);
+        }
+        else
+        {
+            std::destroy_n(data_ + n, size_ - n);
+        }
+        size_ = n;
+    }
+
+private:
+    // Geometric growth, so repeated bulk appends still cost amortized O(1)
+    void grow_for(std::size_t extra)
+    {
+        if (size_ + extra > capacity_)
+        {
+            reallocate(std::max(size_ + extra, 2 * capacity_));
+        }
+    }
+
+    void reallocate(std::size_t new_capacity)
+    {
+        relocate_into(allocate(new_capacity), new_capacity);
+    }
+
+    static T *allocate(std::size_t n)
+    {
+        return static_cast<T *>(::operator new(n * sizeof(T), std::align_val_t{kAlign}));
+    }
+
+    // Moves the current elements into `fresh` and frees the old buffer
+    void relocate_into(T *fresh, std::size_t new_capacity)
+    {
+        if constexpr (std::is_trivially_copyable_v<T>)
+        {
+            if (size_)
+            {
+                std::memcpy(fresh, data_, size_ * sizeof(T));
+            }
+        }
+        else
+        {
+            std::uninitialized_move(data_, data_ + size_, fresh);
+            std::destroy_n(data_, size_);
+        }
+        deallocate(data_);
+        data_ = fresh;
+        capacity_ = new_capacity;
+    }
+
+    static void deallocate(T *p)
+    {
+        if (p)
+        {
+            ::operator delete(p, std::align_val_t{kAlign});
+        }
+    }
+
+    T *data_ = nullptr;
+    std::size_t size_ = 0;
+    std::size_t capacity_ = 0;
+};
+
+// ------------------------ SIMD FILL KERNELS -----------------------------
+
+// Above this size the data won't stay in cache anyway, so bypass it
+constexpr std::size_t kStreamingBytes = 8u << 20;
+
+// out[i] = start + i
+void fill_iota(std::span<int32_t> out, int32_t start)
+{
+    std::size_t i = 0;
+#if defined(__AVX2__)
+    int32_t *p = out.data();
+    // scalar until 32-byte aligned
+    for (; i < out.size() && reinterpret_cast<uintptr_t>(p + i) % 32 != 0; i++)
+    {
+        p[i] = start + static_cast<int32_t>(i);
+    }
+    __m256i v = _mm256_add_epi32(_mm256_set1_epi32(start + static_cast<int32_t>(i)), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+    const __m256i step = _mm256_set1_epi32(8);
+    bool stream = out.size_bytes() >= kStreamingBytes;
+    for (; i + 8 <= out.size(); i += 8)
+    {
+        if (stream)
+        {
+            _mm256_stream_si256(reinterpret_cast<__m256i *>(p + i), v); // no read-for-ownership
+        }
+        else
+        {
+            _mm256_store_si256(reinterpret_cast<__m256i *>(p + i), v);
+        }
+        v = _mm256_add_epi32(v, step);
+    }
+    if (stream)
+    {
+        _mm_sfence(); // make streaming stores visible before anyone reads
+    }
+#endif
+    for (; i < out.size(); i++)
+    {
+        out[i] = start + static_cast<int32_t>(i);
+    }
+}
+
+// out[i] = value
+void fill_value(std::span<int32_t> out, int32_t value)
+{
+    std::size_t i = 0;
+#if defined(__AVX2__)
+    int32_t *p = out.data();
+    for (; i < out.size() && reinterpret_cast<uintptr_t>(p + i) % 32 != 0; i++)
+    {
+        p[i] = value;
+    }
+    const __m256i v = _mm256_set1_epi32(value);
+    bool stream = out.size_bytes() >= kStreamingBytes;
+    for (; i + 8 <= out.size(); i += 8)
+    {
+        if (stream)
+        {
+            _mm256_stream_si256(reinterpret_cast<__m256i *>(p + i), v);
+        }
+        else
+        {
+            _mm256_store_si256(reinterpret_cast<__m256i *>(p + i), v);
+        }
+    }
+    if (stream)
+    {
+        _mm_sfence();
+    }
+#endif
+    for (; i < out.size(); i++)
+    {
+        out[i] = value;
+    }
+}
+
+// ------------------------ BENCHMARK -----------------------------
+
+template <typename F>
+double time_ms(F &&f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+template <typename V>
+bool is_iota(const V &v, std::size_t n)
+{
+    if (v.size() != n)
+    {
+        return false;
+    }
+    for (std::size_t i = 0; i < n; i++)
+    {
+        if (v[i] != static_cast<int32_t>(i))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void report(const char *name, double ms, std::size_t n, bool ok)
+{
+    double bytes = static_cast<double>(n) * sizeof(int32_t);
+    std::cout << "  " << name << ms << " ms, " << ms * 1e6 / static_cast<double>(n) << " ns/elem, "
+              << bytes / ms / 1e6 << " GB/s" << (ok ? "" : "  WRONG") << '\n';
+}
+
+int main(int argc, char **argv)
+{
+    std::size_t n = argc > 1 ? std::stoull(argv[1]) : 100'000'000;
+    auto to_int = [](std::size_t i)
+    { return static_cast<int32_t>(i); };
+
+    // Self-append (the source lives in the buffer being grown) and moves
+    {
+        BulkVector<int32_t> v;
+        v.append_n(20, to_int); // 0..19, capacity 20
+        v.append(std::span<const int32_t>(v.data(), v.size()));
+        v.push_back(v[0]); // may reallocate while reading v[0]
+        BulkVector<int32_t> moved = std::move(v);
+        bool ok = moved.size() == 41 && moved[20] == 0 && moved[39] == 19 && moved[40] == 0 && v.size() == 0;
+        std::cout << "self-append + move: " << (ok ? "ok" : "WRONG") << "\n\n";
+    }
+
+    std::cout << "Filling " << n / 1'000'000 << "M int32 with 0..N-1 (" << n * 4 / (1 << 20) << " MB)\n";
+#if defined(__AVX2__)
+    std::cout << "(AVX2 fill kernels, streaming stores above " << (kStreamingBytes >> 20) << " MB)\n";
+#endif
+
+    // Fresh memory each time: includes page faults, like the first fill of a new vector
+    std::cout << "\nFresh vectors:\n";
+    {
+        std::vector<int32_t> v;
+        double ms = time_ms([&]
+                            { for (std::size_t i = 0; i < n; i++) { v.push_back(to_int(i)); } });
+        report("std::vector push_back:           ", ms, n, is_iota(v, n));
+    }
+    {
+        std::vector<int32_t> v;
+        double ms = time_ms([&]
+                            { v.reserve(n); for (std::size_t i = 0; i < n; i++) { v.push_back(to_int(i)); } });
+        report("std::vector reserve + push_back: ", ms, n, is_iota(v, n));
+    }
+    {
+        std::vector<int32_t> v;
+        double ms = time_ms([&]
+                            { v.resize(n); std::iota(v.begin(), v.end(), 0); });
+        report("std::vector resize + iota:       ", ms, n, is_iota(v, n));
+    }
+    {
+        BulkVector<int32_t> v;
+        double ms = time_ms([&]
+                            { v.append_n(n, to_int); });
+        report("BulkVector append_n:             ", ms, n, is_iota(v, n));
+    }
+    {
+        BulkVector<int32_t> v;
+        double ms = time_ms([&]
+                            { v.resize_default_init(n); fill_iota({v.data(), n}, 0); });
+        report("BulkVector default_init + iota:  ", ms, n, is_iota(v, n));
+    }
+
+    // Refilling a vector that already has the capacity: no page faults, pure write bandwidth
+    std::cout << "\nRefill (capacity already there):\n";
+    {
+        std::vector<int32_t> v;
+        v.reserve(n);
+        v.assign(n, 0);
+        double ms = time_ms([&]
+                            { v.clear(); for (std::size_t i = 0; i < n; i++) { v.push_back(to_int(i)); } });
+        report("std::vector push_back:           ", ms, n, is_iota(v, n));
+    }
+    {
+        BulkVector<int32_t> v;
+        v.resize_default_init(n);
+        fill_value({v.data(), n}, 0);
+        double ms = time_ms([&]
+                            { v.clear(); v.append_n(n, to_int); });
+        report("BulkVector append_n:             ", ms, n, is_iota(v, n));
+        ms = time_ms([&]
+                     { v.clear(); v.resize_default_init(n); fill_iota({v.data(), n}, 0); });
+        report("BulkVector fill_iota:            ", ms, n, is_iota(v, n));
+    }
+
+    // append(span): one memcpy instead of n push_backs
+    {
+        std::vector<int32_t> src(n / 10);
+        std::iota(src.begin(), src.end(), 0);
+        BulkVector<int32_t> v;
+        v.reserve(n); // capacity up front: each append is then just a memcpy
+        double ms = time_ms([&]
+                            { for (int r = 0; r < 10; r++) { v.append(src); } });
+        std::cout << "\nappend(span) 10 x " << src.size() / 1'000'000 << "M: " << ms << " ms, size = " << v.size()
+                  << ", capacity = " << v.capacity() << '\n';
+    }
+    return 0;
+}
+
+/*
+----------------------------------------------------------------------
+KEY TAKEAWAYS:
+----------------------------------------------------------------------
+1. push_back pays a capacity check and a size update per element, and
+   the loop can't be vectorized. Bulk APIs check capacity ONCE.
+
+2. reserve() removes the reallocation copies; append_n also removes the
+   per-element check, so the fill loop vectorizes.
+
+3. std::vector::resize(n) zero-fills. If we overwrite everything next,
+   resize_default_init skips that extra pass over memory.
+
+4. For fills bigger than the cache, streaming stores avoid reading each
+   line before writing it, so the fill runs at memory write bandwidth.
+
+5. Growing must copy the new elements BEFORE freeing the old buffer:
+   v.append(v) reads from the memory being replaced.
+
+6. The first touch of fresh memory costs page faults (see
+   34numa_huge_pages.cpp); reusing capacity (clear + refill) avoids them.
+
+- How to Run:
+    g++ 54bulk_append_vector.cpp -o bulk --std=c++20 -O2 -march=native
+    ./bulk 1000000000   // 1B elements needs 4 GB free
+----------------------------------------------------------------------
+*/
@@ -0,0 +1,486 @@
+#include <iostream>    // For std::cout
+#include <vector>      // For the std::vector baseline
+#include <memory>      // For std::unique_ptr, std::construct_at, std::destroy_at
+#include <new>         // For aligned operator new / delete
+#include <utility>     // For std::move
+#include <type_traits> // For the trait
+#include <cstring>     // For std::memcpy
+#include <algorithm>   // For std::max
+#include <chrono>      // For timing
+#include <cstdint>     // For std::uintptr_t
+
+/*
+----------------------------------------------------------------------
+TOPIC: TRIVIALLY RELOCATABLE TYPES
+----------------------------------------------------------------------
+MyArray in 33move.cpp owns a heap array. Its move constructor copies the
+pointer and nulls the source; then the source's destructor runs and does
+`delete[] nullptr` (nothing).
+
+When std::vector<MyArray> grows, for EVERY element it does:
+    new (dst) MyArray(std::move(src));   // copy 2 fields, null 2 fields
+    src.~MyArray();                      // a call that does nothing useful
+All of that together is equivalent to just copying the bytes of src to
+dst and forgetting src. That's "relocation":
+
+    move-construct + destroy source  ==  memcpy     (for such types)
+
+Types where this holds are TRIVIALLY RELOCATABLE. Most resource handles
+are: unique_ptr, MyArray, a string with a heap pointer... The exception:
+types that store a pointer INTO THEMSELVES (e.g. a small-string buffer
+pointing at its own inline chars), because after memcpy it would point
+into the old object.
+
+C++ has no standard trait for this yet (proposals P1144 / P2786), so we
+make our own opt-in trait, and containers that use memcpy when it's set.
+----------------------------------------------------------------------
+*/
+
+// ------------------------ THE TRAIT -----------------------------
+
+// Default: only trivially copyable types. Everything else must opt in.
+template <typename T>
+struct is_trivially_relocatable : std::bool_constant<std::is_trivially_copyable_v<T>>
+{
+};
+
+template <typename T>
+inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
+// unique_ptr is a pointer (+ deleter): fine to move by memcpy in practice
+template <typename T, typename D>
+struct is_trivially_relocatable<std::unique_ptr<T, D>> : std::bool_constant<is_trivially_relocatable_v<D>>
+{
+};
+
+/*
+Moves n objects from src to (uninitialized) dst and ends their lifetime
+in src. Ranges may not overlap.
+Note: memcpy on a non-trivially-copyable type is formally outside the
+standard today; it's what the relocation proposals make official and what
+major libraries (Folly, Qt, BSL) already do.
+*/
+template <typename T>
+void relocate(T *src, std::size_t n, T *dst)
+{
+    if constexpr (is_trivially_relocatable_v<T>)
+    {
+        if (n)
+        {
+            std::memcpy(static_cast<void *>(dst), static_cast<const void *>(src), n * sizeof(T));
+        }
+    }
+    else
+    {
+        for (std::size_t i = 0; i < n; i++)
+        {
+            std::construct_at(dst + i, std::move(src[i]));
+            std::destroy_at(src + i);
+        }
+    }
+}
+
+// ------------------------ A MyArray-LIKE HANDLE -----------------------------
+
+// Like MyArray from 33move.cpp, but counting instead of printing
+struct Buffer
+{
+    static inline long moves = 0;
+    static inline long destructor_calls = 0;
+
+    int *data;
+    std::size_t size;
+
+    explicit Buffer(std::size_t n) : data(new int[n]()), size(n) {}
+
+    Buffer(Buffer &&other) noexcept : data(other.data), size(other.size)
+    {
+        moves++;
+        other.data = nullptr;
+        other.size = 0;
+    }
+
+    Buffer(const Buffer &) = delete;
+    Buffer &operator=(const Buffer &) = delete;
+
+    ~Buffer()
+    {
+        destructor_calls++;
+        delete[] data;
+    }
+
+    static void reset_counts() { moves = destructor_calls = 0; }
+};
+
+// The opt-in: no member points into the object itself
+template <>
+struct is_trivially_relocatable<Buffer> : std::true_type
+{
+};
+
+// ------------------------ RelocVector<T> -----------------------------
+
+template <typename T>
+class RelocVector
+{
+public:
+    RelocVector() = default;
+    RelocVector(const RelocVector &) = delete;
+    RelocVector &operator=(const RelocVector &) = delete;
+
+    ~RelocVector()
+    {
+        std::destroy_n(data_, size_);
+        ::operator delete(data_, std::align_val_t{alignof(T)});
+    }
+
+    template <typename... Args>
+    T &emplace_back(Args &&...args)
+    {
+        if (size_ == capacity_)
+        {
+            grow(std::max<std::size_t>(8, 2 * capacity_));
+        }
+        T *p = std::construct_at(data_ + size_, std::forward<Args>(args)...);
+        size_++;
+        return *p;
+    }
+
+    // Remove element i, shifting the rest down: one memmove for relocatable T
+    void erase(std::size_t i)
+    {
+        std::destroy_at(data_ + i);
+        if constexpr (is_trivially_relocatable_v<T>)
+        {
+            std::memmove(static_cast<void *>(data_ + i), static_cast<const void *>(data_ + i + 1), (size_ - i - 1) * sizeof(T));
+        }
+        else
+        {
+            for (std::size_t j = i; j + 1 < size_; j++)
+            {
+                std::construct_at(data_ + j, std::move(data_[j + 1]));
+                std::destroy_at(data_ + j + 1);
+            }
+        }
+        size_--;
+    }
+
+    void reserve(std::size_t n)
+    {
+        if (n > capacity_)
+        {
+            grow(n);
+        }
+    }
+
+    T &operator[](std::size_t i) { return data_[i]; }
+    std::size_t size() const { return size_; }
+
+private:
+    void grow(std::size_t new_capacity)
+    {
+        T *fresh = static_cast<T *>(::operator new(new_capacity * sizeof(T), std::align_val_t{alignof(T)}));
+        relocate(data_, size_, fresh); // ONE memcpy for relocatable T
+        ::operator delete(data_, std::align_val_t{alignof(T)});
+        data_ = fresh;
+        capacity_ = new_capacity;
+    }
+
+    T *data_ = nullptr;
+    std::size_t size_ = 0;
+    std::size_t capacity_ = 0;
+};
+
+// ------------------------ SmallVector<T, N> -----------------------------
+
+/*
+First N elements live inside the object (no heap allocation), then it
+spills to the heap. Moving from inline storage to the heap is a relocation.
+*/
+template <typename T, std::size_t N>
+class SmallVector
+{
+public:
+    SmallVector() = default;
+    SmallVector(const SmallVector &) = delete;
+    SmallVector &operator=(const SmallVector &) = delete;
+
+    ~SmallVector()
+    {
+        std::destroy_n(data_, size_);
+        if (!is_inline())
+        {
+            ::operator delete(data_, std::align_val_t{alignof(T)});
+        }
+    }
+
+    template <typename... Args>
+    T &emplace_back(Args &&...args)
+    {
+        if (size_ == capacity_)
+        {
+            T *fresh = static_cast<T *>(::operator new(2 * capacity_ * sizeof(T), std::align_val_t{alignof(T)}));
+            relocate(data_, size_, fresh);
+            if (!is_inline())
+            {
+                ::operator delete(data_, std::align_val_t{alignof(T)});
+            }
+            data_ = fresh;
+            capacity_ *= 2;
+        }
+        T *p = std::construct_at(data_ + size_, std::forward<Args>(args)...);
+        size_++;
+        return *p;
+    }
+
+    T &operator[](std::size_t i) { return data_[i]; }
+    std::size_t size() const { return size_; }
+    bool is_inline() const { return data_ == reinterpret_cast<const T *>(inline_); }
+
+private:
+    alignas(T) unsigned char inline_[N * sizeof(T)];
+    T *data_ = reinterpret_cast<T *>(inline_);
+    std::size_t size_ = 0;
+    std::size_t capacity_ = N;
+};
+
+// ------------------------ RingBuffer<T> -----------------------------
+
+/*
+Growable FIFO queue. When it grows, the wrapped-around contents are
+relocated into the new buffer in order: at most two memcpys.
+*/
+template <typename T>
+class RingBuffer
+{
+public:
+    RingBuffer() = default;
+    RingBuffer(const RingBuffer &) = delete;
+    RingBuffer &operator=(const RingBuffer &) = delete;
+
+    ~RingBuffer()
+    {
+        while (size_)
+        {
+            pop_front();
+        }
+        ::operator delete(data_, std::align_val_t{alignof(T)});
+    }
+
+    template <typename... Args>
+    void emplace_back(Args &&...args)
+    {
+        if (size_ == capacity_)
+        {
+            grow();
+        }
+        std::construct_at(data_ + (head_ + size_) % capacity_, std::forward<Args>(args)...);
+        size_++;
+    }
+
+    T pop_front()
+    {
+        T value = std::move(data_[head_]);
+        std::destroy_at(data_ + head_);
+        head_ = (head_ + 1) % capacity_;
+        size_--;
+        return value;
+    }
+
+    T &front() { return data_[head_]; }
+    std::size_t size() const { return size_; }
+
+private:
+    void grow()
+    {
+        std::size_t new_capacity = std::max<std::size_t>(8, 2 * capacity_);
+        T *fresh = static_cast<T *>(::operator new(new_capacity * sizeof(T), std::align_val_t{alignof(T)}));
+        std::size_t first = std::min(size_, capacity_ - head_); // head .. end of buffer
+        relocate(data_ + head_, first, fresh);
+        relocate(data_, size_ - first, fresh + first); // wrapped part
+        ::operator delete(data_, std::align_val_t{alignof(T)});
+        data_ = fresh;
+        capacity_ = new_capacity;
+        head_ = 0;
+    }
+
+    T *data_ = nullptr;
+    std::size_t head_ = 0;
+    std::size_t size_ = 0;
+    std::size_t capacity_ = 0;
+};
+
+// ------------------------ BENCHMARK -----------------------------
+
+template <typename F>
+double time_ms(F &&f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+int main(int argc, char **argv)
+{
+    std::size_t n = argc > 1 ? std::stoull(argv[1]) : 2'000'000;
+
+    static_assert(is_trivially_relocatable_v<Buffer>);
+    static_assert(is_trivially_relocatable_v<std::unique_ptr<int[]>>);
+    static_assert(!is_trivially_relocatable_v<std::vector<int>>, "not opted in");
+
+    // 1. Growing a vector of handles
+    std::cout << "Appending " << n << " Buffers (growth moves + destructor calls, excluding final cleanup):\n";
+    {
+        Buffer::reset_counts();
+        long moves = 0, dtors = 0;
+        double ms = time_ms([&]
+                            {
+            std::vector<Buffer> v;
+            for (std::size_t i = 0; i < n; i++) { v.emplace_back(1); }
+            moves = Buffer::moves;
+            dtors = Buffer::destructor_calls; });
+        std::cout << "  std::vector:  " << ms << " ms, " << moves << " moves, " << dtors << " destructor calls\n";
+    }
+    {
+        Buffer::reset_counts();
+        long moves = 0, dtors = 0;
+        double ms = time_ms([&]
+                            {
+            RelocVector<Buffer> v;
+            for (std::size_t i = 0; i < n; i++) { v.emplace_back(1); }
+            moves = Buffer::moves;
+            dtors = Buffer::destructor_calls; });
+        std::cout << "  RelocVector:  " << ms << " ms, " << moves << " moves, " << dtors << " destructor calls\n";
+    }
+
+    // 2. Growth alone: a cache-sized vector reallocated many times, so we
+    //    measure the per-element work rather than page faults on new memory
+    {
+        constexpr std::size_t kSmall = 10'000;
+        constexpr int kRounds = 200;
+        double t_std = 0, t_reloc = 0;
+        for (int round = 0; round < kRounds; round++)
+        {
+            std::vector<Buffer> v;
+            RelocVector<Buffer> r;
+            v.reserve(kSmall);
+            r.reserve(kSmall);
+            for (std::size_t i = 0; i < kSmall; i++)
+            {
+                v.emplace_back(1);
+                r.emplace_back(1);
+            }
+            t_std += time_ms([&]
+                             { v.reserve(2 * kSmall); });
+            t_reloc += time_ms([&]
+                               { r.reserve(2 * kSmall); });
+        }
+        std::cout << "\nReallocating " << kSmall << " elements (avg of " << kRounds << "): std::vector "
+                  << t_std / kRounds * 1000 << " us, RelocVector " << t_reloc / kRounds * 1000 << " us\n";
+    }
+
+    // 3. SmallVector: inline first, then spill to the heap by relocation
+    {
+        Buffer::reset_counts();
+        SmallVector<Buffer, 4> sv;
+        for (int i = 0; i < 4; i++)
+        {
+            sv.emplace_back(static_cast<std::size_t>(i + 1));
+        }
+        std::cout << "\nSmallVector<Buffer, 4>: 4 elements, inline = " << sv.is_inline();
+        sv.emplace_back(5);
+        std::cout << "; 5th element, inline = " << sv.is_inline() << ", sizes";
+        for (std::size_t i = 0; i < sv.size(); i++)
+        {
+            std::cout << ' ' << sv[i].size;
+        }
+        std::cout << ", moves = " << Buffer::moves << '\n';
+    }
+
+    // 4. RingBuffer: grow while wrapped around, order is kept
+    {
+        RingBuffer<std::unique_ptr<int>> q;
+        for (int i = 0; i < 6; i++)
+        {
+            q.emplace_back(std::make_unique<int>(i));
+        }
+        q.pop_front();
+        q.pop_front();
+        for (int i = 6; i < 12; i++) // wraps, then grows
+        {
+            q.emplace_back(std::make_unique<int>(i));
+        }
+        std::cout << "RingBuffer<unique_ptr<int>> after wrap + grow:";
+        while (q.size())
+        {
+            std::cout << ' ' << *q.pop_front();
+        }
+        std::cout << '\n';
+    }
+
+    // 5. erase(0) on a RelocVector: one memmove
+    {
+        RelocVector<std::unique_ptr<int>> v;
+        for (int i = 0; i < 5; i++)
+        {
+            v.emplace_back(std::make_unique<int>(i * 10));
+        }
+        v.erase(0);
+        std::cout << "RelocVector erase(0):";
+        for (std::size_t i = 0; i < v.size(); i++)
+        {
+            std::cout << ' ' << *v[i];
+        }
+        std::cout << '\n';
+    }
+
+    // 6. Over-aligned elements: storage must honour alignof(T), not just sizeof(T)
+    {
+        struct alignas(64) CacheLine
+        {
+            int value;
+        };
+        RelocVector<CacheLine> v;
+        SmallVector<CacheLine, 2> sv;
+        RingBuffer<CacheLine> q;
+        bool aligned = true;
+        for (int i = 0; i < 100; i++)
+        {
+            v.emplace_back(CacheLine{i});
+            sv.emplace_back(CacheLine{i});
+            q.emplace_back(CacheLine{i});
+            aligned &= reinterpret_cast<std::uintptr_t>(&v[0]) % 64 == 0 &&
+                       reinterpret_cast<std::uintptr_t>(&sv[0]) % 64 == 0 &&
+                       reinterpret_cast<std::uintptr_t>(&q.front()) % 64 == 0;
+        }
+        std::cout << "alignas(64) elements in all three containers: "
+                  << (aligned && v[99].value == 99 && sv[99].value == 99 ? "aligned" : "MISALIGNED") << '\n';
+    }
+    return 0;
+}
+
+/*
+----------------------------------------------------------------------
+KEY TAKEAWAYS:
+----------------------------------------------------------------------
+1. Relocation = move-construct into new storage + destroy the source.
+   For most handle types that is exactly a byte copy.
+
+2. An opt-in trait (is_trivially_relocatable<T>) lets containers replace
+   N move constructors + N destructor calls with one memcpy.
+
+3. Don't opt in types that point into themselves (inline buffers with a
+   self-pointer, intrusive list nodes); memcpy would leave dangling
+   pointers.
+
+4. The same trick helps everywhere elements move in bulk: vector growth,
+   erase (memmove), small-vector spill, ring-buffer growth.
+
+5. Raw storage comes from operator new(bytes, std::align_val_t{alignof(T)})
+   and goes back through the matching delete, so alignas(64) types work.
+
+- How to Run:
+    g++ 55trivially_relocatable.cpp -o reloc --std=c++20 -O2
+----------------------------------------------------------------------
+*/
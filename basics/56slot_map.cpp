@@ -0,0 +1,294 @@
+#include <iostream>  // For std::cout
+#include <vector>    // For dense storage and the free list
+#include <memory>    // For std::shared_ptr (the baseline, see 23shared_pointer.cpp)
+#include <cstdint>   // For uint32_t
+#include <utility>   // For std::move, std::swap
+#include <algorithm> // For std::shuffle
+#include <random>    // For random access patterns
+#include <chrono>    // For timing
+
+/*
+----------------------------------------------------------------------
+TOPIC: SLOT MAP (generational handles instead of pointers)
+----------------------------------------------------------------------
+raw_vs_unique_vs_shared.cpp compares raw pointers, unique_ptr and
+shared_ptr. When objects refer to each other (a scene graph, game
+entities, connections), shared_ptr is the "safe" default, but:
+- every object is a separate heap allocation, scattered in memory, so
+  looping over all of them is a cache miss per object;
+- every copy of a shared_ptr is an atomic increment/decrement;
+- holding a shared_ptr keeps the object alive, even when the rest of
+  the program considers it deleted.
+
+A slot map stores all objects of one type in ONE dense std::vector and
+hands out HANDLES instead of pointers:
+
+    Handle = { index: 32 bits, generation: 32 bits }   (8 bytes, trivially copyable)
+
+- index picks a slot; the slot says where the object is in the dense vector.
+- generation counts how many times the slot was filled and emptied
+  (odd = occupied). Erasing bumps it, so an old handle no longer
+  matches → a "stale handle" is detected with one comparison instead
+  of crashing like a dangling raw pointer.
+- Erase moves the LAST object into the hole, so the vector stays dense
+  (iteration is a plain loop over contiguous memory). Handles stay valid
+  because only the slot's index is updated.
+
+insert, erase and lookup are all O(1).
+----------------------------------------------------------------------
+*/
+
+// ------------------------ HANDLE -----------------------------
+
+struct Handle
+{
+    uint32_t index = UINT32_MAX;
+    uint32_t generation = 0;
+
+    bool operator==(const Handle &) const = default;
+};
+
+// ------------------------ SLOT MAP -----------------------------
+
+template <typename T>
+class SlotMap
+{
+public:
+    Handle insert(T value)
+    {
+        uint32_t slot_index;
+        if (free_head_ != kNone)
+        {
+            slot_index = free_head_; // reuse a freed slot
+            free_head_ = slots_[slot_index].dense_or_next_free;
+        }
+        else
+        {
+            slot_index = static_cast<uint32_t>(slots_.size());
+            slots_.push_back(Slot{0, 0});
+        }
+        Slot &slot = slots_[slot_index];
+        slot.generation++; // even → odd: occupied
+        slot.dense_or_next_free = static_cast<uint32_t>(values_.size());
+        values_.push_back(std::move(value));
+        dense_to_slot_.push_back(slot_index);
+        return {slot_index, slot.generation};
+    }
+
+    // nullptr if the handle is stale (its object was erased) or never valid
+    T *get(Handle h)
+    {
+        if (!contains(h))
+        {
+            return nullptr;
+        }
+        return &values_[slots_[h.index].dense_or_next_free];
+    }
+
+    bool contains(Handle h) const
+    {
+        // Only odd generations are ever handed out. Checking that first means a
+        // forged {i, even} handle can't match a free or retired (0) slot
+        return (h.generation & 1) && h.index < slots_.size() && slots_[h.index].generation == h.generation;
+    }
+
+    bool erase(Handle h)
+    {
+        if (!contains(h))
+        {
+            return false;
+        }
+        Slot &slot = slots_[h.index];
+        uint32_t hole = slot.dense_or_next_free;
+        uint32_t last = static_cast<uint32_t>(values_.size() - 1);
+
+        // Keep the dense array dense: move the last object into the hole
+        if (hole != last)
+        {
+            values_[hole] = std::move(values_[last]);
+            dense_to_slot_[hole] = dense_to_slot_[last];
+            slots_[dense_to_slot_[hole]].dense_or_next_free = hole;
+        }
+        values_.pop_back();
+        dense_to_slot_.pop_back();
+
+        if (slot.generation == kLastGeneration)
+        {
+            // One more reuse would wrap to generation 1 and revive ancient
+            // handles. Retire the slot: 0 matches no handle, and it never
+            // goes back on the free list (costs 8 bytes per 2^31 reuses).
+            slot.generation = 0;
+            retired_++;
+            return true;
+        }
+        slot.generation++; // odd → even: free, and every handle to it is now stale
+        slot.dense_or_next_free = free_head_;
+        free_head_ = h.index;
+        return true;
+    }
+
+    std::size_t size() const { return values_.size(); }
+    std::size_t retired_slots() const { return retired_; }
+
+    // Dense iteration: plain contiguous loop, order changes after erase
+    auto begin() { return values_.begin(); }
+    auto end() { return values_.end(); }
+
+    // Handle of the i-th object in iteration order
+    Handle handle_at(std::size_t dense_index) const
+    {
+        uint32_t s = dense_to_slot_[dense_index];
+        return {s, slots_[s].generation};
+    }
+
+private:
+    static constexpr uint32_t kNone = UINT32_MAX;
+    static constexpr uint32_t kLastGeneration = UINT32_MAX; // largest odd value
+
+    struct Slot
+    {
+        uint32_t dense_or_next_free; // occupied: position in values_; free: next free slot
+        uint32_t generation;         // odd = occupied, even = free; retired (0) before it can wrap
+    };
+
+    std::vector<T> values_;               // the objects, contiguous
+    std::vector<uint32_t> dense_to_slot_; // values_[i] belongs to slots_[dense_to_slot_[i]]
+    std::vector<Slot> slots_;
+    uint32_t free_head_ = kNone;
+    std::size_t retired_ = 0;
+};
+
+// ------------------------ BENCHMARK -----------------------------
+
+struct Particle
+{
+    float x, y, vx, vy;
+};
+
+template <typename F>
+double time_ms(F &&f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+int main(int argc, char **argv)
+{
+    std::size_t n = argc > 1 ? std::stoull(argv[1]) : 1'000'000;
+    std::mt19937 rng(7);
+
+    // 1. Stale handle detection
+    SlotMap<Particle> demo;
+    Handle a = demo.insert({1, 2, 0, 0});
+    Handle b = demo.insert({3, 4, 0, 0});
+    demo.erase(a);
+    Handle c = demo.insert({5, 6, 0, 0}); // reuses a's slot with a new generation
+    std::cout << "a = {" << a.index << ", gen " << a.generation << "}, c = {" << c.index << ", gen " << c.generation << "}\n"
+              << "get(a) after erase: " << (demo.get(a) ? "FOUND (bug)" : "nullptr (stale)")
+              << ", get(b).x = " << demo.get(b)->x << ", get(c).x = " << demo.get(c)->x << '\n';
+    demo.erase(c);
+    Handle forged{c.index, c.generation + 1}; // even = the free slot's own generation
+    std::cout << "forged handle {" << forged.index << ", gen " << forged.generation << "}: get "
+              << (demo.get(forged) ? "FOUND (bug)" : "nullptr") << ", erase " << demo.erase(forged)
+              << ", size still " << demo.size() << "\n\n";
+
+    // 2. shared_ptr objects vs slot map, N objects, inserted interleaved with other allocations
+    std::vector<std::shared_ptr<Particle>> ptrs;
+    std::vector<std::unique_ptr<char[]>> noise; // other allocations scatter the Particles, like a real heap
+    SlotMap<Particle> map;
+    std::vector<Handle> handles;
+    for (std::size_t i = 0; i < n; i++)
+    {
+        Particle p{static_cast<float>(i), 0, 1, 2};
+        ptrs.push_back(std::make_shared<Particle>(p));
+        noise.push_back(std::make_unique<char[]>(16 + rng() % 200));
+        handles.push_back(map.insert(p));
+    }
+    // shuffle the references, like edges of a graph pointing anywhere
+    std::vector<std::size_t> order(n);
+    for (std::size_t i = 0; i < n; i++)
+    {
+        order[i] = i;
+    }
+    std::shuffle(order.begin(), order.end(), rng);
+    std::vector<std::shared_ptr<Particle>> ptr_refs(n);
+    std::vector<Handle> handle_refs(n);
+    for (std::size_t i = 0; i < n; i++)
+    {
+        ptr_refs[i] = ptrs[order[i]];
+        handle_refs[i] = handles[order[i]];
+    }
+
+    float s1 = 0, s2 = 0;
+    double t_iter_ptr = time_ms([&]
+                                { for (auto &p : ptrs) { p->x += p->vx; s1 += p->x; } });
+    double t_iter_map = time_ms([&]
+                                { for (Particle &p : map) { p.x += p.vx; s2 += p.x; } });
+
+    double t_look_ptr = time_ms([&]
+                                { for (auto &p : ptr_refs) { s1 += p->y; } });
+    double t_look_map = time_ms([&]
+                                { for (Handle h : handle_refs) { s2 += map.get(h)->y; } });
+
+    std::size_t copies = 0;
+    double t_copy_ptr = time_ms([&]
+                                { std::vector<std::shared_ptr<Particle>> copy = ptr_refs; copies += copy.size(); });
+    double t_copy_map = time_ms([&]
+                                { std::vector<Handle> copy = handle_refs; copies += copy.size(); });
+
+    // erase a random half, through the shuffled references
+    std::size_t erased = 0;
+    double t_erase_ptr = time_ms([&]
+                                 { for (std::size_t i = 0; i < n / 2; i++) { ptrs[order[i]].reset(); ptr_refs[i].reset(); } });
+    double t_erase_map = time_ms([&]
+                                 { for (std::size_t i = 0; i < n / 2; i++) { erased += map.erase(handle_refs[i]); } });
+    std::size_t stale = 0;
+    for (Handle h : handle_refs)
+    {
+        stale += !map.contains(h);
+    }
+
+    std::cout << n / 1000 << "K particles, ms      shared_ptr   SlotMap\n"
+              << "  iterate all            " << t_iter_ptr << "\t" << t_iter_map << '\n'
+              << "  random lookups         " << t_look_ptr << "\t" << t_look_map << '\n'
+              << "  copy all references    " << t_copy_ptr << "\t" << t_copy_map << '\n'
+              << "  erase half             " << t_erase_ptr << "\t" << t_erase_map << '\n'
+              << "  reference size         " << sizeof(std::shared_ptr<Particle>) << " B\t\t" << sizeof(Handle) << " B\n"
+              << "(" << erased << " erased, " << stale << " handles now stale, " << map.size() << " left, sums "
+              << (s1 == s2 ? "agree" : "DIFFER") << ", " << copies << " copies)\n";
+    return 0;
+}
+
+/*
+----------------------------------------------------------------------
+KEY TAKEAWAYS:
+----------------------------------------------------------------------
+1. Store objects of one type contiguously; refer to them by handle
+   (index + generation), not by pointer.
+
+2. Iterating the dense vector is a plain array loop: no pointer chasing,
+   no cache miss per object.
+
+3. Handles are 8 trivially copyable bytes: copying them does no atomic
+   refcount work (shared_ptr copies do).
+
+4. Erase = move the last object into the hole (O(1)) + bump the slot's
+   generation. Every old handle to that slot now fails the generation
+   check → stale handles are detected, never dereferenced. A 32-bit
+   generation would wrap after 2^31 reuses of one slot, so such a slot is
+   retired instead of reused: detection stays exact forever.
+
+5. The price: a random lookup is two dependent loads (slot, then object)
+   instead of one, so pure random access by handle can be slower than a
+   pointer dereference. The wins are iteration, copies and memory.
+
+6. Unlike shared_ptr, a handle doesn't keep the object alive: ownership
+   stays with the SlotMap, lifetime is explicit.
+
+- How to Run:
+    g++ 56slot_map.cpp -o slotmap --std=c++20 -O2
+    ./slotmap 5000000   // optional number of objects
+----------------------------------------------------------------------
+*/
@@ -0,0 +1,506 @@
+#include <iostream>    // For std::cout
+#include <array>       // For fixed-size vectors / matrices (see 09std_arrays.cpp)
+#include <vector>      // For benchmark data
+#include <span>        // For the run-time-size baselines (see 24std_span.cpp)
+#include <algorithm>   // For std::max
+#include <utility>     // For std::index_sequence
+#include <cstdint>     // For uint8_t / uint32_t / uint64_t
+#include <cstdio>      // For std::snprintf (formatting baseline)
+#include <cstring>     // For std::memcpy
+#include <bit>         // For std::popcount
+#include <string>      // For the CRC input
+#include <string_view> // For crc32()
+#include <cmath>       // For std::abs
+#include <random>      // For benchmark data
+#include <chrono>      // For timing
+
+/*
+----------------------------------------------------------------------
+TOPIC: SIZE KNOWN AT COMPILE TIME → STRAIGHT-LINE CODE
+----------------------------------------------------------------------
+14temp_specialization.cpp specializes print_my_array for array<int, 3>.
+The same idea pays off for NUMERIC code: when N is part of the type
+(std::array<T, N>), the compiler knows the trip count, so we can expand
+the loop completely at compile time. No loop counter, no branch, no
+remainder handling, and the fixed pattern is easy to map onto SIMD.
+
+Two tools:
+1. std::index_sequence + fold expressions: write "do this for I = 0..N-1"
+   and the compiler expands it into N statements.
+2. Pairwise (tree) reduction: ((a0+a1)+(a2+a3)) instead of
+   (((a0+a1)+a2)+a3). The additions in each level are independent, so the
+   CPU runs them in parallel; for float the compiler may NOT reorder a
+   serial chain itself (results would change), so we give it the tree.
+
+We only unroll up to N = 64; above that, code size grows for little gain
+and a normal loop is used.
+
+Second half: lookup tables computed by constexpr functions. The table is
+built by the COMPILER and stored in the binary; at run time it's just an
+array read. Examples: CRC32, byte popcount, "00".."99" digit pairs for
+fast integer → text.
+----------------------------------------------------------------------
+*/
+
+// ------------------------ UNROLLED REDUCTIONS -----------------------------
+
+inline constexpr std::size_t kMaxUnroll = 64;
+
+// Combines f(Lo) .. f(Hi - 1) as a balanced tree, fully expanded at compile time
+template <std::size_t Lo, std::size_t Hi, typename F, typename Op>
+constexpr auto tree_reduce(const F &f, const Op &op)
+{
+    if constexpr (Hi - Lo == 1)
+    {
+        return f(std::integral_constant<std::size_t, Lo>{});
+    }
+    else
+    {
+        constexpr std::size_t Mid = Lo + (Hi - Lo) / 2;
+        return op(tree_reduce<Lo, Mid>(f, op), tree_reduce<Mid, Hi>(f, op));
+    }
+}
+
+template <typename T, std::size_t N>
+constexpr T dot(const std::array<T, N> &a, const std::array<T, N> &b)
+{
+    static_assert(N > 0);
+    if constexpr (N <= kMaxUnroll)
+    {
+        return tree_reduce<0, N>([&](auto i)
+                                 { return a[i] * b[i]; },
+                                 [](T x, T y)
+                                 { return x + y; });
+    }
+    else
+    {
+        T acc{};
+        for (std::size_t i = 0; i < N; i++)
+        {
+            acc += a[i] * b[i];
+        }
+        return acc;
+    }
+}
+
+template <typename T, std::size_t N>
+constexpr T sum(const std::array<T, N> &a)
+{
+    static_assert(N > 0);
+    if constexpr (N <= kMaxUnroll)
+    {
+        return tree_reduce<0, N>([&](auto i)
+                                 { return a[i]; },
+                                 [](T x, T y)
+                                 { return x + y; });
+    }
+    else
+    {
+        T acc{};
+        for (const T &x : a)
+        {
+            acc += x;
+        }
+        return acc;
+    }
+}
+
+template <typename T, std::size_t N>
+constexpr T max_of(const std::array<T, N> &a)
+{
+    static_assert(N > 0);
+    if constexpr (N <= kMaxUnroll)
+    {
+        return tree_reduce<0, N>([&](auto i)
+                                 { return a[i]; },
+                                 [](T x, T y)
+                                 { return x < y ? y : x; });
+    }
+    else
+    {
+        T best = a[0];
+        for (std::size_t i = 1; i < N; i++)
+        {
+            best = best < a[i] ? a[i] : best;
+        }
+        return best;
+    }
+}
+
+template <typename T, std::size_t N>
+constexpr T min_of(const std::array<T, N> &a)
+{
+    static_assert(N > 0);
+    if constexpr (N <= kMaxUnroll)
+    {
+        return tree_reduce<0, N>([&](auto i)
+                                 { return a[i]; },
+                                 [](T x, T y)
+                                 { return y < x ? y : x; });
+    }
+    else
+    {
+        T best = a[0];
+        for (std::size_t i = 1; i < N; i++)
+        {
+            best = a[i] < best ? a[i] : best;
+        }
+        return best;
+    }
+}
+
+// ------------------------ SMALL MATRICES -----------------------------
+
+template <typename T, std::size_t R, std::size_t C>
+using Mat = std::array<std::array<T, C>, R>;
+
+// out[i][j] = sum over k of a[i][k] * b[k][j]; every (i, j, k) expanded for small sizes
+template <typename T, std::size_t M, std::size_t K, std::size_t N>
+constexpr Mat<T, M, N> matmul(const Mat<T, M, K> &a, const Mat<T, K, N> &b)
+{
+    Mat<T, M, N> out{};
+    if constexpr (M * N <= kMaxUnroll && K <= kMaxUnroll)
+    {
+        [&]<std::size_t... Idx>(std::index_sequence<Idx...>)
+        {
+            ((out[Idx / N][Idx % N] = tree_reduce<0, K>([&](auto k)
+                                                        { return a[Idx / N][k] * b[k][Idx % N]; },
+                                                        [](T x, T y)
+                                                        { return x + y; })),
+             ...);
+        }(std::make_index_sequence<M * N>{});
+    }
+    else
+    {
+        // i-k-j order: the inner loop walks rows of b and out contiguously
+        for (std::size_t i = 0; i < M; i++)
+        {
+            for (std::size_t k = 0; k < K; k++)
+            {
+                for (std::size_t j = 0; j < N; j++)
+                {
+                    out[i][j] += a[i][k] * b[k][j];
+                }
+            }
+        }
+    }
+    return out;
+}
+
+// Everything above is constexpr, so it can be checked while compiling
+static_assert(dot(std::array{1, 2, 3}, std::array{4, 5, 6}) == 32);
+static_assert(max_of(std::array{3, 9, -2, 7}) == 9 && min_of(std::array{3, 9, -2, 7}) == -2);
+static_assert(matmul<int, 2, 2, 2>(Mat<int, 2, 2>{{{1, 2}, {3, 4}}}, Mat<int, 2, 2>{{{5, 6}, {7, 8}}}) ==
+              Mat<int, 2, 2>{{{19, 22}, {43, 50}}});
+
+// Past kMaxUnroll the same calls take the loop fallback
+constexpr std::array<int, 100> kRamp = []
+{
+    std::array<int, 100> r{};
+    for (int i = 0; i < 100; i++)
+    {
+        r[i] = i - 40;
+    }
+    return r;
+}();
+static_assert(sum(kRamp) == 950 && max_of(kRamp) == 59 && min_of(kRamp) == -40);
+constexpr Mat<int, 9, 9> kIdentity9 = []
+{
+    Mat<int, 9, 9> m{};
+    for (std::size_t i = 0; i < 9; i++)
+    {
+        m[i][i] = 1;
+    }
+    return m;
+}();
+static_assert(matmul(kIdentity9, kIdentity9) == kIdentity9); // 81 outputs > kMaxUnroll
+
+// ------------------------ RUN-TIME SIZE BASELINES -----------------------------
+
+template <typename T>
+T dot_dynamic(std::span<const T> a, std::span<const T> b)
+{
+    T acc{};
+    for (std::size_t i = 0; i < a.size(); i++)
+    {
+        acc += a[i] * b[i];
+    }
+    return acc;
+}
+
+// Row-major m x k times k x n, sizes known only at run time
+template <typename T>
+void matmul_dynamic(const T *a, const T *b, T *out, std::size_t m, std::size_t k, std::size_t n)
+{
+    for (std::size_t i = 0; i < m; i++)
+    {
+        for (std::size_t j = 0; j < n; j++)
+        {
+            T acc{};
+            for (std::size_t x = 0; x < k; x++)
+            {
+                acc += a[i * k + x] * b[x * n + j];
+            }
+            out[i * n + j] = acc;
+        }
+    }
+}
+
+// ------------------------ CONSTEXPR LOOKUP TABLES -----------------------------
+
+// CRC-32 (zlib / PNG / Ethernet polynomial), one entry per byte value
+constexpr std::array<uint32_t, 256> make_crc32_table()
+{
+    std::array<uint32_t, 256> table{};
+    for (uint32_t i = 0; i < 256; i++)
+    {
+        uint32_t c = i;
+        for (int bit = 0; bit < 8; bit++)
+        {
+            c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+        }
+        table[i] = c;
+    }
+    return table;
+}
+
+inline constexpr auto kCrc32Table = make_crc32_table();
+
+constexpr uint32_t crc32(std::string_view data)
+{
+    uint32_t crc = 0xFFFFFFFFu;
+    for (char ch : data)
+    {
+        crc = kCrc32Table[(crc ^ static_cast<uint8_t>(ch)) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+// Same result, one bit at a time: what the table saves us
+uint32_t crc32_bitwise(std::string_view data)
+{
+    uint32_t crc = 0xFFFFFFFFu;
+    for (char ch : data)
+    {
+        crc ^= static_cast<uint8_t>(ch);
+        for (int bit = 0; bit < 8; bit++)
+        {
+            crc = (crc & 1) ? 0xEDB88320u ^ (crc >> 1) : crc >> 1;
+        }
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+static_assert(crc32("123456789") == 0xCBF43926u, "standard CRC-32 check value");
+
+constexpr std::array<uint8_t, 256> make_popcount_table()
+{
+    std::array<uint8_t, 256> table{};
+    for (int i = 0; i < 256; i++)
+    {
+        table[i] = static_cast<uint8_t>((i & 1) + table[i / 2]);
+    }
+    return table;
+}
+
+inline constexpr auto kPopcount8 = make_popcount_table();
+
+// Bytes of a 64-bit word looked up in the table (std::popcount uses the
+// POPCNT instruction when available; the table is the portable fallback)
+constexpr int popcount_table(uint64_t x)
+{
+    int n = 0;
+    for (int i = 0; i < 8; i++)
+    {
+        n += kPopcount8[(x >> (8 * i)) & 0xFF];
+    }
+    return n;
+}
+
+static_assert(popcount_table(0xFF00FF00FF00FF00ull) == 32);
+
+// "00" "01" ... "99": 200 chars, so integer formatting can emit 2 digits per step
+constexpr std::array<char, 200> make_digit_pairs()
+{
+    std::array<char, 200> table{};
+    for (int i = 0; i < 100; i++)
+    {
+        table[2 * i] = static_cast<char>('0' + i / 10);
+        table[2 * i + 1] = static_cast<char>('0' + i % 10);
+    }
+    return table;
+}
+
+inline constexpr auto kDigitPairs = make_digit_pairs();
+
+// Writes value in decimal to out (needs 10 chars), returns the length
+inline std::size_t format_u32(uint32_t value, char *out)
+{
+    char buf[10];
+    char *p = buf + 10;
+    while (value >= 100)
+    {
+        uint32_t pair = value % 100;
+        value /= 100;
+        p -= 2;
+        std::memcpy(p, &kDigitPairs[2 * pair], 2);
+    }
+    if (value >= 10)
+    {
+        p -= 2;
+        std::memcpy(p, &kDigitPairs[2 * value], 2);
+    }
+    else
+    {
+        *--p = static_cast<char>('0' + value);
+    }
+    std::size_t len = static_cast<std::size_t>(buf + 10 - p);
+    std::memcpy(out, p, len);
+    return len;
+}
+
+// ------------------------ BENCHMARK -----------------------------
+
+template <typename F>
+double time_ms(F &&f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+int main(int argc, char **argv)
+{
+    std::size_t count = argc > 1 ? std::stoull(argv[1]) : 1'000'000;
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+
+    // 1. dot of float[16] pairs: fixed N vs run-time N. A small set reused
+    //    many times, so we measure the arithmetic, not memory bandwidth
+    constexpr std::size_t kN = 16, kSet = 1024;
+    std::vector<std::array<float, kN>> xs(kSet), ys(kSet);
+    for (std::size_t i = 0; i < kSet; i++)
+    {
+        for (std::size_t j = 0; j < kN; j++)
+        {
+            xs[i][j] = dist(rng);
+            ys[i][j] = dist(rng);
+        }
+    }
+    volatile std::size_t hidden_n = kN;  // read back at run time: the compiler can't know it is 16
+    const std::size_t runtime_n = hidden_n; // ...but it can never exceed the rows it indexes
+    std::size_t reps = std::max<std::size_t>(1, count / kSet);
+    float d1 = 0, d2 = 0;
+    double t_dot_fixed = time_ms([&]
+                                 { for (std::size_t r = 0; r < reps; r++) {
+            for (std::size_t i = 0; i < kSet; i++) { d1 += dot(xs[i], ys[i]); } } });
+    double t_dot_dyn = time_ms([&]
+                               { for (std::size_t r = 0; r < reps; r++) {
+            for (std::size_t i = 0; i < kSet; i++) { d2 += dot_dynamic<float>({xs[i].data(), runtime_n}, {ys[i].data(), runtime_n}); } } });
+
+    // 2. 4x4 matrix chain
+    Mat<float, 4, 4> m{}, acc{};
+    for (auto &row : m)
+    {
+        for (auto &v : row)
+        {
+            v = dist(rng) * 0.5f;
+        }
+    }
+    for (std::size_t i = 0; i < 4; i++)
+    {
+        acc[i][i] = 1.0f;
+    }
+    Mat<float, 4, 4> acc_dyn = acc, tmp{};
+    volatile std::size_t hidden_dim = 4; // same trick: always 4, opaque to the optimizer
+    const std::size_t dim = hidden_dim;
+    double t_mm_fixed = time_ms([&]
+                                { for (std::size_t i = 0; i < count; i++) { acc = matmul(acc, m); acc[0][0] += 1e-7f; } });
+    double t_mm_dyn = time_ms([&]
+                              { for (std::size_t i = 0; i < count; i++) {
+            matmul_dynamic(&acc_dyn[0][0], &m[0][0], &tmp[0][0], dim, dim, dim);
+            acc_dyn = tmp; acc_dyn[0][0] += 1e-7f; } });
+
+    // 3. CRC32: table vs bit-by-bit
+    std::string data(count * 16, '\0');
+    for (char &ch : data)
+    {
+        ch = static_cast<char>(rng());
+    }
+    uint32_t c1 = 0, c2 = 0;
+    double t_crc_table = time_ms([&]
+                                 { c1 = crc32(data); });
+    double t_crc_bits = time_ms([&]
+                                { c2 = crc32_bitwise(data); });
+
+    // 4. Popcount: table vs std::popcount
+    std::vector<uint64_t> words(count);
+    for (auto &w : words)
+    {
+        w = (static_cast<uint64_t>(rng()) << 32) | rng();
+    }
+    long p1 = 0, p2 = 0;
+    double t_pop_table = time_ms([&]
+                                 { for (uint64_t w : words) { p1 += popcount_table(w); } });
+    double t_pop_std = time_ms([&]
+                               { for (uint64_t w : words) { p2 += std::popcount(w); } });
+
+    // 5. Integer formatting: digit pairs vs snprintf
+    std::vector<uint32_t> ints(count);
+    for (auto &v : ints)
+    {
+        v = static_cast<uint32_t>(rng());
+    }
+    std::vector<char> text(count * 11);
+    std::size_t len1 = 0, len2 = 0;
+    double t_fmt_pairs = time_ms([&]
+                                 {
+        char *out = text.data();
+        for (uint32_t v : ints) { std::size_t n = format_u32(v, out); out[n] = ' '; out += n + 1; len1 += n; } });
+    std::vector<char> text2(count * 11 + 1);
+    double t_fmt_printf = time_ms([&]
+                                  {
+        char *out = text2.data();
+        for (uint32_t v : ints) { int n = std::snprintf(out, 12, "%u ", v); out += n; len2 += static_cast<std::size_t>(n - 1); } });
+    bool same_text = len1 == len2 && std::memcmp(text.data(), text2.data(), len1 + count) == 0;
+
+    std::cout << count / 1000 << "K items, ms:\n"
+              << "  dot<float, 16>     fixed " << t_dot_fixed << "\tvs run-time N " << t_dot_dyn
+              << "\t(" << (std::abs(d1 - d2) < 1e-2f * std::abs(d1) + 1 ? "agree" : "DIFFER") << ")\n"
+              << "  4x4 matmul         fixed " << t_mm_fixed << "\tvs run-time N " << t_mm_dyn
+              << "\t(" << (std::abs(acc[1][1] - acc_dyn[1][1]) < 1e-3f ? "agree" : "DIFFER") << ")\n"
+              << "  CRC32 " << data.size() / (1 << 20) << " MB        table " << t_crc_table << "\tvs bitwise " << t_crc_bits
+              << "\t(" << (c1 == c2 ? "agree" : "DIFFER") << ")\n"
+              << "  popcount           table " << t_pop_table << "\tvs std::popcount " << t_pop_std
+              << "\t(" << (p1 == p2 ? "agree" : "DIFFER") << ")\n"
+              << "  format uint32      pairs " << t_fmt_pairs << "\tvs snprintf " << t_fmt_printf
+              << "\t(" << (same_text ? "agree" : "DIFFER") << ")\n";
+    return 0;
+}
+
+/*
+----------------------------------------------------------------------
+KEY TAKEAWAYS:
+----------------------------------------------------------------------
+1. Put the size in the type (std::array<T, N>) and the compiler can
+   expand loops completely: index_sequence + fold expressions, or
+   `if constexpr` recursion like tree_reduce.
+
+2. Tree reductions expose independent operations (instruction-level
+   parallelism and SIMD); a serial float chain can't be reordered by the
+   compiler without -ffast-math.
+
+3. Cap the unrolling (here N ≤ 64); big unrolled bodies cost
+   instruction cache.
+
+4. constexpr functions can build lookup tables at compile time, and
+   static_assert can test the kernels before the program even runs.
+
+5. A table replaces per-bit or per-digit work with one array read:
+   CRC32 8 bits at a time, digits 2 at a time.
+
+- How to Run:
+    g++ 57fixed_size_kernels.cpp -o fixed --std=c++20 -O2 -march=native
+----------------------------------------------------------------------
+*/